@@ -4,107 +4,80 @@
 #include <iostream>
 #include <iomanip>
 #include <cmath>
-#include <queue>
 #include <set>
 
-DifficultyAnalyzer::DifficultyAnalyzer(int size) : gridSize(size), maxDepth(500), maxStates(50000) {}
+DifficultyAnalyzer::DifficultyAnalyzer(int size) : gridSize(size), maxDepth(500), maxStates(50000),
+                                                   rules(SolverRules::ALL_DIRECTIONS) {}
 
 bool GameState::operator==(const GameState& other) const {
-    if (tiles.size() != other.tiles.size()) return false;
-    
-    for (size_t i = 0; i < tiles.size(); i++) {
-        if (tiles[i].gridCol != other.tiles[i].gridCol ||
-            tiles[i].gridRow != other.tiles[i].gridRow ||
-            tiles[i].unitType != other.tiles[i].unitType) {
-            return false;
-        }
-    }
-    return true;
+    return hashValue == other.hashValue && cells == other.cells;
 }
 
 size_t GameState::hash() const {
-    size_t h = 0;
-    for (const auto& tile : tiles) {
-        h ^= std::hash<int>{}(tile.gridCol) + 0x9e3779b9 + (h << 6) + (h >> 2);
-        h ^= std::hash<int>{}(tile.gridRow) + 0x9e3779b9 + (h << 6) + (h >> 2);
-        h ^= std::hash<int>{}(static_cast<int>(tile.unitType)) + 0x9e3779b9 + (h << 6) + (h >> 2);
-    }
-    return h;
+    return static_cast<size_t>(hashValue);
 }
 
 size_t GameStateHash::operator()(const GameState& state) const {
     return state.hash();
 }
 
-bool DifficultyAnalyzer::isOutOfBounds(int col, int row, int colSpan, int rowSpan) {
-    return col < 1 || col + colSpan - 1 > gridSize ||
-           row < 1 || row + rowSpan - 1 > gridSize;
+int DifficultyAnalyzer::firstDirection(const SearchState& state, int tileIndex) const {
+    return rules == SolverRules::OWN_DIRECTION ? static_cast<int>(state.level->shape(tileIndex).direction) : 0;
 }
 
-bool DifficultyAnalyzer::checkCollision(const std::vector<Tile>& tiles, int excludeIndex, 
-                                       int col, int row, int colSpan, int rowSpan) {
-    int tileLeft = col;
-    int tileRight = col + colSpan - 1;
-    int tileTop = row;
-    int tileBottom = row + rowSpan - 1;
-    
-    for (size_t i = 0; i < tiles.size(); i++) {
-        if (i == static_cast<size_t>(excludeIndex)) continue;
-        
-        const Tile& other = tiles[i];
-        int otherLeft = other.gridCol;
-        int otherRight = other.gridCol + other.gridColSpan - 1;
-        int otherTop = other.gridRow;
-        int otherBottom = other.gridRow + other.gridRowSpan - 1;
-        
-        if (tileLeft <= otherRight && tileRight >= otherLeft &&
-            tileTop <= otherBottom && tileBottom >= otherTop) {
-            return true;
-        }
-    }
-    return false;
+int DifficultyAnalyzer::lastDirection(const SearchState& state, int tileIndex) const {
+    return rules == SolverRules::OWN_DIRECTION ? static_cast<int>(state.level->shape(tileIndex).direction) : 3;
+}
+
+int DifficultyAnalyzer::stepsToEdge(const SearchState& state, int tileIndex, const DirectionVector& vec) {
+    const TileShape& shape = state.level->shape(tileIndex);
+    int col = state.col(tileIndex);
+    int row = state.row(tileIndex);
+    int colSteps = vec.col > 0 ? gridSize - (col + shape.colSpan - 1) : col - 1;
+    int rowSteps = vec.row > 0 ? gridSize - (row + shape.rowSpan - 1) : row - 1;
+    return std::min(colSteps, rowSteps);
 }
 
-bool DifficultyAnalyzer::canSlideTile(const std::vector<Tile>& tiles, int tileIndex, 
+bool DifficultyAnalyzer::canSlideTile(const SearchState& state, int tileIndex,
                                     Direction dir, int& newCol, int& newRow, bool& willDisappear) {
-    const Tile& tile = tiles[tileIndex];
     const DirectionVector& vec = DIRECTION_VECTORS[static_cast<int>(dir)];
     
-    int currentCol = tile.gridCol;
-    int currentRow = tile.gridRow;
-    newCol = currentCol;
-    newRow = currentRow;
+    Bitboard footprint = state.footprint(tileIndex);
+    Bitboard others = state.occupancy.andNot(footprint);
+    int delta = Bitboard::stepDelta(vec.col, vec.row);
+    int steps = stepsToEdge(state, tileIndex, vec);
+    
+    newCol = state.col(tileIndex);
+    newRow = state.row(tileIndex);
     willDisappear = false;
     
-    while (true) {
-        int nextCol = newCol + vec.col;
-        int nextRow = newRow + vec.row;
-        
-        if (isOutOfBounds(nextCol, nextRow, tile.gridColSpan, tile.gridRowSpan)) {
-            willDisappear = true;
-            return true;
+    for (int step = 0; step < steps; step++) {
+        footprint = footprint.shifted(delta);
+        if (footprint.intersects(others)) {
+            return step > 0;
         }
-        
-        if (checkCollision(tiles, tileIndex, nextCol, nextRow, tile.gridColSpan, tile.gridRowSpan)) {
-            return newCol != currentCol || newRow != currentRow;
-        }
-        
-        newCol = nextCol;
-        newRow = nextRow;
+        newCol += vec.col;
+        newRow += vec.row;
     }
+    
+    willDisappear = true;
+    return true;
 }
 
-std::vector<Move> DifficultyAnalyzer::getPossibleMoves(const std::vector<Tile>& tiles) {
+std::vector<Move> DifficultyAnalyzer::getPossibleMoves(const SearchState& state) {
     std::vector<Move> moves;
+    int tileCount = state.level->tileCount();
     
-    for (size_t i = 0; i < tiles.size(); i++) {
-        for (int dir = 0; dir < 4; dir++) {
+    for (int i = 0; i < tileCount; i++) {
+        if (state.exited(i)) continue;
+        
+        for (int dir = firstDirection(state, i); dir <= lastDirection(state, i); dir++) {
             int newCol, newRow;
             bool willDisappear;
             
-            if (canSlideTile(tiles, i, static_cast<Direction>(dir), newCol, newRow, willDisappear)) {
-                if (newCol != tiles[i].gridCol || newRow != tiles[i].gridRow || willDisappear) {
-                    moves.push_back({static_cast<int>(i), newCol, newRow, willDisappear});
+            if (canSlideTile(state, i, static_cast<Direction>(dir), newCol, newRow, willDisappear)) {
+                if (newCol != state.col(i) || newRow != state.row(i) || willDisappear) {
+                    moves.push_back({i, newCol, newRow, willDisappear});
                 }
             }
         }
@@ -113,128 +86,124 @@ std::vector<Move> DifficultyAnalyzer::getPossibleMoves(const std::vector<Tile>&
     return moves;
 }
 
-bool DifficultyAnalyzer::hasDogEscaped(const std::vector<Tile>& tiles) {
-    for (const auto& tile : tiles) {
-        if (tile.unitType == UnitType::DOG) {
-            int right = tile.gridCol + tile.gridColSpan - 1;
-            int bottom = tile.gridRow + tile.gridRowSpan - 1;
-            return tile.gridCol < 1 || right > gridSize || 
-                   tile.gridRow < 1 || bottom > gridSize;
-        }
-    }
-    return false;
+bool DifficultyAnalyzer::hasDogEscaped(const SearchState& state) {
+    int dogIndex = state.level->getDogIndex();
+    return dogIndex >= 0 && state.exited(dogIndex);
+}
+
+int DifficultyAnalyzer::targetCell(const Move& move) {
+    return move.disappeared ? SearchState::EXITED : Bitboard::cellIndex(move.newCol, move.newRow);
 }
 
-bool DifficultyAnalyzer::solveBFS(std::vector<Tile> tiles, std::vector<Move>& solution, int& statesExplored) {
-    std::queue<std::pair<std::vector<Tile>, std::vector<Move>>> queue;
-    std::unordered_set<GameState, GameStateHash> visited;
+bool DifficultyAnalyzer::solveBFS(const std::vector<Tile>& tiles, std::vector<Move>& solution, int& statesExplored) {
+    LevelDescriptor descriptor(tiles, gridSize);
+    SearchState currentState(descriptor, tiles);
+    StateTable visited(currentState.cells.size(), static_cast<size_t>(maxStates) + 1);
+    std::vector<SearchNode> nodes;
+    nodes.reserve(std::min<size_t>(static_cast<size_t>(maxStates) + 1, size_t(1) << 22));
     
-    GameState initialState(tiles);
-    visited.insert(initialState);
-    queue.push({tiles, {}});
+    visited.insert(currentState.cells.data(), currentState.hash);
+    nodes.push_back({0, {-1, 0, 0, false}});
     
+    uint32_t head = 0;
     statesExplored = 0;
     
-    while (!queue.empty()) {
+    while (head < visited.size()) {
         statesExplored++;
         if (statesExplored > maxStates) return false;
         
-        auto current = queue.front();
-        queue.pop();
-        
-        auto currentTiles = current.first;
-        auto currentMoves = current.second;
+        uint32_t current = head++;
+        currentState.assign(visited.state(current), visited.hashAt(current));
         
-        if (hasDogEscaped(currentTiles)) {
-            solution = currentMoves;
+        if (hasDogEscaped(currentState)) {
+            solution = tracePath(nodes, current);
             return true;
         }
         
-        auto moves = getPossibleMoves(currentTiles);
+        auto moves = getPossibleMoves(currentState);
         
         for (const auto& move : moves) {
-            auto newTiles = currentTiles;
-            newTiles[move.tileIndex].gridCol = move.newCol;
-            newTiles[move.tileIndex].gridRow = move.newRow;
+            int oldCell = currentState.cells[move.tileIndex];
+            currentState.moveTile(move.tileIndex, targetCell(move));
             
-            GameState newState(newTiles);
-            if (!visited.count(newState)) {
-                visited.insert(newState);
-                
-                auto newMoves = currentMoves;
-                newMoves.push_back(move);
-                
-                queue.push({newTiles, newMoves});
+            if (visited.insert(currentState.cells.data(), currentState.hash).second) {
+                nodes.push_back({current, move});
             }
+            
+            currentState.moveTile(move.tileIndex, oldCell);
         }
     }
     
     return false;
 }
 
-bool DifficultyAnalyzer::solveDFS(std::vector<Tile> tiles, int depth, 
-                                   std::unordered_set<GameState, GameStateHash>& visited,
+std::vector<Move> DifficultyAnalyzer::tracePath(const std::vector<SearchNode>& nodes, uint32_t index) {
+    std::vector<Move> path;
+    while (index != 0) {
+        path.push_back(nodes[index].move);
+        index = nodes[index].parent;
+    }
+    
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+bool DifficultyAnalyzer::solveDFS(SearchState& state, int depth, 
+                                   StateTable& visited,
                                    int& deadEnds, int& maxDepthReached) {
     if (depth > maxDepth) return false;
     
     maxDepthReached = std::max(maxDepthReached, depth);
     
-    GameState currentState(tiles);
-    if (visited.count(currentState)) {
+    if (!visited.insert(state.cells.data(), state.hash).second) {
         deadEnds++;
         return false;
     }
-    visited.insert(currentState);
     
-    if (hasDogEscaped(tiles)) return true;
+    if (hasDogEscaped(state)) return true;
     
-    auto moves = getPossibleMoves(tiles);
+    auto moves = getPossibleMoves(state);
+    int dogIndex = state.level->getDogIndex();
     
     std::vector<Move> dogMoves;
     std::vector<Move> otherMoves;
     
     for (const auto& move : moves) {
-        if (tiles[move.tileIndex].unitType == UnitType::DOG) {
+        if (move.tileIndex == dogIndex) {
             dogMoves.push_back(move);
         } else {
             otherMoves.push_back(move);
         }
     }
     
+    // Clearing a wolf off the board is usually progress, so try exits first.
+    std::stable_partition(otherMoves.begin(), otherMoves.end(),
+                          [](const Move& move) { return move.disappeared; });
+    
     for (const auto& move : dogMoves) {
-        Tile& tile = tiles[move.tileIndex];
-        int oldCol = tile.gridCol;
-        int oldRow = tile.gridRow;
-        
-        tile.gridCol = move.newCol;
-        tile.gridRow = move.newRow;
-        
         if (move.disappeared) {
             return true;
         }
         
-        if (solveDFS(tiles, depth + 1, visited, deadEnds, maxDepthReached)) {
+        int oldCell = state.cells[move.tileIndex];
+        state.moveTile(move.tileIndex, Bitboard::cellIndex(move.newCol, move.newRow));
+        
+        if (solveDFS(state, depth + 1, visited, deadEnds, maxDepthReached)) {
             return true;
         }
         
-        tile.gridCol = oldCol;
-        tile.gridRow = oldRow;
+        state.moveTile(move.tileIndex, oldCell);
     }
     
     for (const auto& move : otherMoves) {
-        Tile& tile = tiles[move.tileIndex];
-        int oldCol = tile.gridCol;
-        int oldRow = tile.gridRow;
-        
-        tile.gridCol = move.newCol;
-        tile.gridRow = move.newRow;
+        int oldCell = state.cells[move.tileIndex];
+        state.moveTile(move.tileIndex, targetCell(move));
         
-        if (solveDFS(tiles, depth + 1, visited, deadEnds, maxDepthReached)) {
+        if (solveDFS(state, depth + 1, visited, deadEnds, maxDepthReached)) {
             return true;
         }
         
-        tile.gridCol = oldCol;
-        tile.gridRow = oldRow;
+        state.moveTile(move.tileIndex, oldCell);
     }
     
     deadEnds++;
@@ -277,13 +246,15 @@ double DifficultyAnalyzer::calculateWolfDensity(const PuzzleLevel& level) {
 
 double DifficultyAnalyzer::calculateAverageMoveOptions(const std::vector<Tile>& tiles) {
     double totalOptions = 0;
+    LevelDescriptor descriptor(tiles, gridSize);
+    SearchState state(descriptor, tiles);
     
     for (size_t i = 0; i < tiles.size(); i++) {
         int options = 0;
-        for (int dir = 0; dir < 4; dir++) {
+        for (int dir = firstDirection(state, i); dir <= lastDirection(state, i); dir++) {
             int newCol, newRow;
             bool willDisappear;
-            if (canSlideTile(tiles, i, static_cast<Direction>(dir), newCol, newRow, willDisappear)) {
+            if (canSlideTile(state, i, static_cast<Direction>(dir), newCol, newRow, willDisappear)) {
                 if (newCol != tiles[i].gridCol || newRow != tiles[i].gridRow || willDisappear) {
                     options++;
                 }
@@ -296,15 +267,18 @@ double DifficultyAnalyzer::calculateAverageMoveOptions(const std::vector<Tile>&
 }
 
 int DifficultyAnalyzer::calculateBranchingFactor(const std::vector<Tile>& tiles) {
-    return static_cast<int>(getPossibleMoves(tiles).size());
+    LevelDescriptor descriptor(tiles, gridSize);
+    return static_cast<int>(getPossibleMoves(SearchState(descriptor, tiles)).size());
 }
 
 int DifficultyAnalyzer::countDeadEndStates(const std::vector<Tile>& tiles) {
-    std::unordered_set<GameState, GameStateHash> visited;
+    LevelDescriptor descriptor(tiles, gridSize);
+    SearchState state(descriptor, tiles);
+    StateTable visited(state.cells.size(), static_cast<size_t>(maxStates) + 1);
     int deadEnds = 0;
     int maxDepthReached = 0;
     
-    solveDFS(tiles, 0, visited, deadEnds, maxDepthReached);
+    solveDFS(state, 0, visited, deadEnds, maxDepthReached);
     
     return deadEnds;
 }
@@ -415,6 +389,10 @@ void DifficultyAnalyzer::setMaxStates(int states) {
     maxStates = states;
 }
 
+void DifficultyAnalyzer::setRules(SolverRules solverRules) {
+    rules = solverRules;
+}
+
 std::string DifficultyAnalyzer::difficultyToString(DifficultyLevel level) {
     switch (level) {
         case DifficultyLevel::VERY_EASY: return "Very Easy";
@@ -2,10 +2,13 @@
 #define DIFFICULTY_ANALYZER_H
 
 #include "Tile.h"
+#include "Bitboard.h"
+#include "SearchState.h"
+#include "StateTable.h"
+#include "SolverOptions.h"
 #include <vector>
 #include <string>
 #include <memory>
-#include <unordered_set>
 
 enum class DifficultyLevel {
     VERY_EASY,
@@ -23,11 +26,10 @@ struct Move {
 };
 
 struct GameState {
-    std::vector<Tile> tiles;
-    std::vector<Move> moves;
-    int moveCount;
+    std::vector<uint8_t> cells;
+    uint64_t hashValue;
     
-    GameState(const std::vector<Tile>& t) : tiles(t), moveCount(0) {}
+    explicit GameState(const SearchState& state) : cells(state.cells), hashValue(state.hash) {}
     bool operator==(const GameState& other) const;
     size_t hash() const;
 };
@@ -36,6 +38,11 @@ struct GameStateHash {
     size_t operator()(const GameState& state) const;
 };
 
+struct SearchNode {
+    uint32_t parent;
+    Move move;
+};
+
 struct DifficultyMetrics {
     int optimalMoves;
     int totalPossibleMoves;
@@ -69,16 +76,21 @@ private:
     int gridSize;
     int maxDepth;
     int maxStates;
+    SolverRules rules;
+    
+    int firstDirection(const SearchState& state, int tileIndex) const;
+    int lastDirection(const SearchState& state, int tileIndex) const;
     
-    bool checkCollision(const std::vector<Tile>& tiles, int excludeIndex, int col, int row, int colSpan, int rowSpan);
-    bool isOutOfBounds(int col, int row, int colSpan, int rowSpan);
-    bool canSlideTile(const std::vector<Tile>& tiles, int tileIndex, Direction dir, int& newCol, int& newRow, bool& willDisappear);
-    std::vector<Move> getPossibleMoves(const std::vector<Tile>& tiles);
-    bool hasDogEscaped(const std::vector<Tile>& tiles);
+    int stepsToEdge(const SearchState& state, int tileIndex, const DirectionVector& vec);
+    bool canSlideTile(const SearchState& state, int tileIndex, Direction dir, int& newCol, int& newRow, bool& willDisappear);
+    std::vector<Move> getPossibleMoves(const SearchState& state);
+    bool hasDogEscaped(const SearchState& state);
+    static int targetCell(const Move& move);
     
-    bool solveBFS(std::vector<Tile> tiles, std::vector<Move>& solution, int& statesExplored);
-    bool solveDFS(std::vector<Tile> tiles, int depth, 
-                  std::unordered_set<GameState, GameStateHash>& visited, 
+    bool solveBFS(const std::vector<Tile>& tiles, std::vector<Move>& solution, int& statesExplored);
+    std::vector<Move> tracePath(const std::vector<SearchNode>& nodes, uint32_t index);
+    bool solveDFS(SearchState& state, int depth, 
+                  StateTable& visited, 
                   int& deadEnds, int& maxDepthReached);
     
     int calculateDogDistanceToEdge(const PuzzleLevel& level);
@@ -100,6 +112,7 @@ public:
     
     void setMaxDepth(int depth);
     void setMaxStates(int states);
+    void setRules(SolverRules solverRules);
     
     std::string difficultyToString(DifficultyLevel level);
     void printMetrics(const DifficultyMetrics& metrics);
@@ -0,0 +1,68 @@
+#include "SearchState.h"
+
+uint64_t zobristKey(int tileIndex, int cell) {
+    uint64_t z = (static_cast<uint64_t>(tileIndex) << 8 | static_cast<uint64_t>(cell)) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+LevelDescriptor::LevelDescriptor(const std::vector<Tile>& tiles, int size) : gridSize(size), dogIndex(-1) {
+    shapes.reserve(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const Tile& tile = tiles[i];
+        TileShape shape;
+        shape.colSpan = tile.gridColSpan;
+        shape.rowSpan = tile.gridRowSpan;
+        shape.unitType = tile.unitType;
+        shape.direction = tile.direction;
+        shape.originMask = Bitboard::rect(1, 1, tile.gridColSpan, tile.gridRowSpan);
+        shapes.push_back(shape);
+
+        if (dogIndex < 0 && tile.unitType == UnitType::DOG) {
+            dogIndex = static_cast<int>(i);
+        }
+    }
+}
+
+SearchState::SearchState(const LevelDescriptor& descriptor, const std::vector<Tile>& tiles)
+    : level(&descriptor), hash(0) {
+    cells.reserve(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++) {
+        int cell = Bitboard::cellIndex(tiles[i].gridCol, tiles[i].gridRow);
+        cells.push_back(static_cast<uint8_t>(cell));
+        occupancy |= footprint(static_cast<int>(i));
+        hash ^= zobristKey(static_cast<int>(i), cell);
+    }
+}
+
+SearchState::SearchState(const LevelDescriptor& descriptor, const std::vector<uint8_t>& packed, uint64_t packedHash)
+    : level(&descriptor), hash(0) {
+    assign(packed.data(), packedHash);
+}
+
+void SearchState::assign(const uint8_t* packed, uint64_t packedHash) {
+    cells.assign(packed, packed + level->tileCount());
+    hash = packedHash;
+    occupancy = Bitboard();
+    for (size_t i = 0; i < cells.size(); i++) {
+        occupancy |= footprint(static_cast<int>(i));
+    }
+}
+
+void SearchState::removeTile(int tileIndex) {
+    moveTile(tileIndex, EXITED);
+}
+
+void SearchState::moveTile(int tileIndex, int newCell) {
+    int oldCell = cells[tileIndex];
+    if (oldCell != EXITED) {
+        occupancy = occupancy.andNot(level->footprint(tileIndex, oldCell));
+        hash ^= zobristKey(tileIndex, oldCell);
+    }
+    if (newCell != EXITED) {
+        occupancy |= level->footprint(tileIndex, newCell);
+        hash ^= zobristKey(tileIndex, newCell);
+    }
+    cells[tileIndex] = static_cast<uint8_t>(newCell);
+}
@@ -0,0 +1,70 @@
+#ifndef SEARCH_STATE_H
+#define SEARCH_STATE_H
+
+#include "Tile.h"
+#include "Bitboard.h"
+#include <vector>
+#include <cstdint>
+
+struct TileShape {
+    int colSpan;
+    int rowSpan;
+    UnitType unitType;
+    Direction direction;
+    Bitboard originMask;
+};
+
+uint64_t zobristKey(int tileIndex, int cell);
+
+// Tile geometry that never changes during a search. Built once per level and
+// shared by every state, so a state only has to record where each tile is.
+class LevelDescriptor {
+private:
+    int gridSize;
+    int dogIndex;
+    std::vector<TileShape> shapes;
+
+public:
+    LevelDescriptor(const std::vector<Tile>& tiles, int gridSize);
+
+    int getGridSize() const { return gridSize; }
+    int getDogIndex() const { return dogIndex; }
+    int tileCount() const { return static_cast<int>(shapes.size()); }
+    const TileShape& shape(int tileIndex) const { return shapes[tileIndex]; }
+
+    Bitboard footprint(int tileIndex, int cell) const {
+        return shapes[tileIndex].originMask.shifted(cell);
+    }
+
+    static int cellCol(int cell) { return cell % Bitboard::STRIDE + 1; }
+    static int cellRow(int cell) { return cell / Bitboard::STRIDE + 1; }
+};
+
+// Mutable search position: one anchor cell per tile, the derived occupancy
+// mask and a Zobrist hash that is updated incrementally on every move.
+// Tiles that slid off the board are marked EXITED and no longer contribute
+// to the occupancy or the hash.
+struct SearchState {
+    static constexpr uint8_t EXITED = 0xff;
+
+    const LevelDescriptor* level;
+    std::vector<uint8_t> cells;
+    Bitboard occupancy;
+    uint64_t hash;
+
+    SearchState(const LevelDescriptor& descriptor, const std::vector<Tile>& tiles);
+    SearchState(const LevelDescriptor& descriptor, const std::vector<uint8_t>& packed, uint64_t packedHash);
+
+    int col(int tileIndex) const { return LevelDescriptor::cellCol(cells[tileIndex]); }
+    int row(int tileIndex) const { return LevelDescriptor::cellRow(cells[tileIndex]); }
+    bool exited(int tileIndex) const { return cells[tileIndex] == EXITED; }
+    Bitboard footprint(int tileIndex) const {
+        return exited(tileIndex) ? Bitboard() : level->footprint(tileIndex, cells[tileIndex]);
+    }
+
+    void assign(const uint8_t* packed, uint64_t packedHash);
+    void moveTile(int tileIndex, int newCell);
+    void removeTile(int tileIndex);
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef SOLVER_OPTIONS_H
+#define SOLVER_OPTIONS_H
+
+#include <string>
+
+// ALL_DIRECTIONS lets every tile slide along any of the four diagonals.
+// OWN_DIRECTION matches the game, where a tile only slides along its
+// own Tile::direction.
+enum class SolverRules {
+    ALL_DIRECTIONS,
+    OWN_DIRECTION
+};
+
+inline std::string solverRulesToString(SolverRules rules) {
+    return rules == SolverRules::OWN_DIRECTION ? "own direction (game rules)" : "all directions";
+}
+
+#endif
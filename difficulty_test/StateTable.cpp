@@ -0,0 +1,77 @@
+#include "StateTable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+const size_t MAX_PRESIZED_STATES = size_t(1) << 22;
+}
+
+StateTable::StateTable(size_t bytes, size_t expectedStates)
+    : stateBytes(bytes), count(0), slotMask(0) {
+    size_t reserved = std::min(std::max<size_t>(expectedStates, 16), MAX_PRESIZED_STATES);
+    size_t slotCount = 16;
+    while (slotCount < reserved * 2) {
+        slotCount <<= 1;
+    }
+
+    slots.assign(slotCount, Slot{0, EMPTY});
+    slotMask = slotCount - 1;
+    arena.reserve(reserved * stateBytes);
+    hashes.reserve(reserved);
+}
+
+std::pair<uint32_t, bool> StateTable::insert(const uint8_t* state, uint64_t hash) {
+    if ((count + 1) * 2 > slots.size()) {
+        rehash(slots.size() * 2);
+    }
+
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t pos = static_cast<size_t>(hash) & slotMask;
+
+    while (slots[pos].index != EMPTY) {
+        const Slot& slot = slots[pos];
+        if (slot.tag == tag && hashes[slot.index] == hash &&
+            std::memcmp(arena.data() + slot.index * stateBytes, state, stateBytes) == 0) {
+            return {slot.index, false};
+        }
+        pos = (pos + 1) & slotMask;
+    }
+
+    uint32_t index = static_cast<uint32_t>(count++);
+    slots[pos] = Slot{tag, index};
+    arena.insert(arena.end(), state, state + stateBytes);
+    hashes.push_back(hash);
+    return {index, true};
+}
+
+bool StateTable::contains(const uint8_t* state, uint64_t hash) const {
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t pos = static_cast<size_t>(hash) & slotMask;
+
+    while (slots[pos].index != EMPTY) {
+        const Slot& slot = slots[pos];
+        if (slot.tag == tag && hashes[slot.index] == hash &&
+            std::memcmp(arena.data() + slot.index * stateBytes, state, stateBytes) == 0) {
+            return true;
+        }
+        pos = (pos + 1) & slotMask;
+    }
+    return false;
+}
+
+void StateTable::rehash(size_t slotCount) {
+    slots.assign(slotCount, Slot{0, EMPTY});
+    slotMask = slotCount - 1;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t pos = static_cast<size_t>(hashes[i]) & slotMask;
+        while (slots[pos].index != EMPTY) {
+            pos = (pos + 1) & slotMask;
+        }
+        slots[pos] = Slot{static_cast<uint32_t>(hashes[i] >> 32), static_cast<uint32_t>(i)};
+    }
+}
+
+size_t StateTable::memoryUsage() const {
+    return slots.capacity() * sizeof(Slot) + arena.capacity() + hashes.capacity() * sizeof(uint64_t);
+}
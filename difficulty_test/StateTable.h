@@ -0,0 +1,46 @@
+#ifndef STATE_TABLE_H
+#define STATE_TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Open-addressing visited set for packed search states. States are copied
+// back-to-back into a single arena in insertion order and addressed by their
+// index, so an insert never allocates once the table has been pre-sized.
+// The probe array holds a 32-bit hash tag next to each index, so most probe
+// misses are rejected without touching the arena.
+class StateTable {
+private:
+    struct Slot {
+        uint32_t tag;
+        uint32_t index;
+    };
+
+    static constexpr uint32_t EMPTY = 0xffffffffu;
+
+    size_t stateBytes;
+    size_t count;
+    size_t slotMask;
+    std::vector<Slot> slots;
+    std::vector<uint8_t> arena;
+    std::vector<uint64_t> hashes;
+
+    void rehash(size_t slotCount);
+
+public:
+    StateTable(size_t stateBytes, size_t expectedStates);
+
+    // Returns the index of the state and whether it was newly inserted.
+    std::pair<uint32_t, bool> insert(const uint8_t* state, uint64_t hash);
+    bool contains(const uint8_t* state, uint64_t hash) const;
+
+    size_t size() const { return count; }
+    size_t bytesPerState() const { return stateBytes; }
+    const uint8_t* state(uint32_t index) const { return arena.data() + index * stateBytes; }
+    uint64_t hashAt(uint32_t index) const { return hashes[index]; }
+    size_t memoryUsage() const;
+};
+
+#endif
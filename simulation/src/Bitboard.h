@@ -0,0 +1,113 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <array>
+#include <cstdint>
+
+// 256-bit cell mask over the puzzle grid. Cells are stored row-major with a
+// fixed stride of 16, so (col, row) maps to bit (row - 1) * 16 + (col - 1)
+// and one diagonal step is a constant shift of +-15 or +-17 bits.
+struct Bitboard {
+    static constexpr int STRIDE = 16;
+    static constexpr int CELLS = 256;
+    // Cell 255 is kept free for the solver's exited-tile marker.
+    static constexpr int MAX_GRID_SIZE = 15;
+
+    std::array<uint64_t, 4> words;
+
+    Bitboard() : words{0, 0, 0, 0} {}
+
+    static int cellIndex(int col, int row) {
+        return (row - 1) * STRIDE + (col - 1);
+    }
+
+    static int stepDelta(int colStep, int rowStep) {
+        return rowStep * STRIDE + colStep;
+    }
+
+    static Bitboard rect(int col, int row, int colSpan, int rowSpan) {
+        Bitboard b;
+        for (int r = row; r < row + rowSpan; r++) {
+            for (int c = col; c < col + colSpan; c++) {
+                b.set(c, r);
+            }
+        }
+        return b;
+    }
+
+    void setBit(int index) { words[index >> 6] |= uint64_t(1) << (index & 63); }
+    void clearBit(int index) { words[index >> 6] &= ~(uint64_t(1) << (index & 63)); }
+    bool testBit(int index) const { return (words[index >> 6] >> (index & 63)) & 1; }
+
+    void set(int col, int row) { setBit(cellIndex(col, row)); }
+    void clear(int col, int row) { clearBit(cellIndex(col, row)); }
+    bool test(int col, int row) const { return testBit(cellIndex(col, row)); }
+
+    bool any() const {
+        return (words[0] | words[1] | words[2] | words[3]) != 0;
+    }
+
+    bool intersects(const Bitboard& other) const {
+        return ((words[0] & other.words[0]) | (words[1] & other.words[1]) |
+                (words[2] & other.words[2]) | (words[3] & other.words[3])) != 0;
+    }
+
+    bool isSubsetOf(const Bitboard& other) const {
+        return ((words[0] & ~other.words[0]) | (words[1] & ~other.words[1]) |
+                (words[2] & ~other.words[2]) | (words[3] & ~other.words[3])) == 0;
+    }
+
+    int count() const {
+        return __builtin_popcountll(words[0]) + __builtin_popcountll(words[1]) +
+               __builtin_popcountll(words[2]) + __builtin_popcountll(words[3]);
+    }
+
+    Bitboard shifted(int n) const {
+        Bitboard r;
+        if (n >= 0) {
+            int ws = n >> 6, bs = n & 63;
+            for (int i = 3; i >= ws; i--) {
+                uint64_t v = words[i - ws] << bs;
+                if (bs && i - ws - 1 >= 0) v |= words[i - ws - 1] >> (64 - bs);
+                r.words[i] = v;
+            }
+        } else {
+            n = -n;
+            int ws = n >> 6, bs = n & 63;
+            for (int i = 0; i + ws <= 3; i++) {
+                uint64_t v = words[i + ws] >> bs;
+                if (bs && i + ws + 1 <= 3) v |= words[i + ws + 1] << (64 - bs);
+                r.words[i] = v;
+            }
+        }
+        return r;
+    }
+
+    Bitboard andNot(const Bitboard& other) const {
+        Bitboard r;
+        for (int i = 0; i < 4; i++) r.words[i] = words[i] & ~other.words[i];
+        return r;
+    }
+
+    Bitboard& operator|=(const Bitboard& o) {
+        for (int i = 0; i < 4; i++) words[i] |= o.words[i];
+        return *this;
+    }
+    Bitboard& operator&=(const Bitboard& o) {
+        for (int i = 0; i < 4; i++) words[i] &= o.words[i];
+        return *this;
+    }
+    Bitboard& operator^=(const Bitboard& o) {
+        for (int i = 0; i < 4; i++) words[i] ^= o.words[i];
+        return *this;
+    }
+
+    friend Bitboard operator|(Bitboard a, const Bitboard& b) { return a |= b; }
+    friend Bitboard operator&(Bitboard a, const Bitboard& b) { return a &= b; }
+    friend Bitboard operator^(Bitboard a, const Bitboard& b) { return a ^= b; }
+
+    bool operator==(const Bitboard& o) const { return words == o.words; }
+    bool operator!=(const Bitboard& o) const { return words != o.words; }
+};
+
+#endif
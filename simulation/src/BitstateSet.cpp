@@ -0,0 +1,50 @@
+#include "BitstateSet.h"
+#include <cmath>
+
+BitstateSet::BitstateSet(int megabytes) : count(0) {
+    size_t bits = 64;
+    size_t budget = static_cast<size_t>(megabytes > 0 ? megabytes : 1) << 23;
+    while (bits * 2 <= budget) {
+        bits <<= 1;
+    }
+    words.assign(bits / 64, 0);
+    bitMask = bits - 1;
+}
+
+// Double hashing: the Zobrist hash is split into a start bit and an odd
+// stride, which is as good as independent hash functions for a Bloom filter.
+bool BitstateSet::insert(uint64_t hash) {
+    uint64_t mixed = hash ^ (hash >> 31);
+    mixed *= 0x7fb5d329728ea185ULL;
+    mixed ^= mixed >> 27;
+    uint64_t stride = (mixed << 1) | 1;
+
+    bool added = false;
+    uint64_t bit = hash;
+    for (int i = 0; i < HASH_COUNT; i++, bit += stride) {
+        uint64_t index = bit & bitMask;
+        uint64_t mask = uint64_t(1) << (index & 63);
+        if (!(words[index >> 6] & mask)) {
+            words[index >> 6] |= mask;
+            added = true;
+        }
+    }
+
+    if (added) count++;
+    return added;
+}
+
+// The n-th new state is lost with probability (1 - e^(-k n / m))^k; the
+// coverage is one minus the average of that over the states inserted.
+double BitstateSet::estimatedCoverage() const {
+    if (count == 0) return 1.0;
+
+    const int samples = 64;
+    double bits = static_cast<double>(bitCount());
+    double lost = 0.0;
+    for (int s = 0; s < samples; s++) {
+        double inserted = count * (s + 0.5) / samples;
+        lost += std::pow(1.0 - std::exp(-HASH_COUNT * inserted / bits), HASH_COUNT);
+    }
+    return 1.0 - lost / samples;
+}
@@ -0,0 +1,32 @@
+#ifndef BITSTATE_SET_H
+#define BITSTATE_SET_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Bitstate ("supertrace") visited set: a Bloom filter that sets HASH_COUNT
+// bits per state in a fixed memory budget and stores nothing else. A state
+// whose bits happen to be set already is wrongly treated as visited, so a
+// search over it may miss states; estimatedCoverage() is the expected
+// fraction of new states that were not lost that way.
+class BitstateSet {
+private:
+    static constexpr int HASH_COUNT = 3;
+
+    std::vector<uint64_t> words;
+    uint64_t bitMask;
+    size_t count;
+
+public:
+    explicit BitstateSet(int megabytes);
+
+    // Returns true if at least one of the state's bits was still clear.
+    bool insert(uint64_t hash);
+
+    size_t size() const { return count; }
+    size_t bitCount() const { return words.size() * 64; }
+    double estimatedCoverage() const;
+};
+
+#endif
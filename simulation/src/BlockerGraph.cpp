@@ -0,0 +1,132 @@
+#include "BlockerGraph.h"
+#include <algorithm>
+
+BlockerGraph::BlockerGraph(int size) : gridSize(size) {}
+
+int BlockerGraph::stepsToEdge(const Tile& tile, const DirectionVector& vec) const {
+    int colSteps = vec.col > 0 ? gridSize - tile.getRight() : tile.gridCol - 1;
+    int rowSteps = vec.row > 0 ? gridSize - tile.getBottom() : tile.gridRow - 1;
+    return std::min(colSteps, rowSteps);
+}
+
+DependencyResult BlockerGraph::analyze(const PuzzleLevel& level) {
+    DependencyResult result;
+    const std::vector<Tile>& tiles = level.tiles;
+    int tileCount = static_cast<int>(tiles.size());
+
+    int dogIndex = -1;
+    for (int i = 0; i < tileCount; i++) {
+        if (tiles[i].unitType == UnitType::DOG) {
+            dogIndex = i;
+            break;
+        }
+    }
+
+    // The owner table below is indexed by Bitboard cell.
+    if (!PuzzleSolver::fitsGrid(level, gridSize)) {
+        result.verdict = DependencyVerdict::INVALID;
+        return result;
+    }
+
+    if (dogIndex < 0) {
+        result.verdict = DependencyVerdict::UNSOLVABLE;
+        return result;
+    }
+
+    std::vector<int> owner(Bitboard::CELLS, -1);
+    for (int i = 0; i < tileCount; i++) {
+        const Tile& tile = tiles[i];
+        for (int r = tile.gridRow; r <= tile.getBottom(); r++) {
+            for (int c = tile.gridCol; c <= tile.getRight(); c++) {
+                owner[Bitboard::cellIndex(c, r)] = i;
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> blockers(tileCount);
+    std::vector<std::vector<int>> dependents(tileCount);
+    std::vector<std::vector<int>> firstStepDependents(tileCount);
+    std::vector<int> firstStepBlockerCount(tileCount, 0);
+    std::vector<int> seen(tileCount, -1);
+
+    for (int i = 0; i < tileCount; i++) {
+        const Tile& tile = tiles[i];
+        const DirectionVector& vec = DIRECTION_VECTORS[static_cast<int>(tile.direction)];
+        int steps = stepsToEdge(tile, vec);
+
+        for (int step = 1; step <= steps; step++) {
+            int col = tile.gridCol + step * vec.col;
+            int row = tile.gridRow + step * vec.row;
+
+            for (int r = row; r < row + tile.gridRowSpan; r++) {
+                for (int c = col; c < col + tile.gridColSpan; c++) {
+                    int other = owner[Bitboard::cellIndex(c, r)];
+                    if (other < 0 || other == i || seen[other] == i) continue;
+
+                    seen[other] = i;
+                    blockers[i].push_back(other);
+                    dependents[other].push_back(i);
+                    if (step == 1) {
+                        firstStepDependents[other].push_back(i);
+                        firstStepBlockerCount[i]++;
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<int> remainingBlockers(tileCount);
+    std::vector<int> exitOrder;
+    std::vector<bool> exited(tileCount, false);
+    exitOrder.reserve(tileCount);
+
+    for (int i = 0; i < tileCount; i++) {
+        remainingBlockers[i] = static_cast<int>(blockers[i].size());
+        if (remainingBlockers[i] == 0) {
+            exitOrder.push_back(i);
+        }
+    }
+
+    for (size_t head = 0; head < exitOrder.size() && !exited[dogIndex]; head++) {
+        int tile = exitOrder[head];
+        exited[tile] = true;
+        for (int dependent : dependents[tile]) {
+            if (--remainingBlockers[dependent] == 0) {
+                exitOrder.push_back(dependent);
+            }
+        }
+    }
+
+    if (exited[dogIndex]) {
+        result.verdict = DependencyVerdict::SOLVABLE;
+        return result;
+    }
+
+    std::vector<bool> frozen(tileCount);
+    std::vector<int> thawed;
+    for (int i = 0; i < tileCount; i++) {
+        frozen[i] = !exited[i] && firstStepBlockerCount[i] > 0;
+        if (!frozen[i]) {
+            thawed.push_back(i);
+        }
+    }
+
+    for (size_t head = 0; head < thawed.size(); head++) {
+        for (int dependent : firstStepDependents[thawed[head]]) {
+            if (frozen[dependent] && --firstStepBlockerCount[dependent] == 0) {
+                frozen[dependent] = false;
+                thawed.push_back(dependent);
+            }
+        }
+    }
+
+    for (int blocker : blockers[dogIndex]) {
+        if (frozen[blocker]) {
+            result.verdict = DependencyVerdict::UNSOLVABLE;
+            return result;
+        }
+    }
+
+    result.verdict = DependencyVerdict::UNDECIDED;
+    return result;
+}
@@ -0,0 +1,41 @@
+#ifndef BLOCKER_GRAPH_H
+#define BLOCKER_GRAPH_H
+
+#include "PuzzleSolver.h"
+#include <vector>
+
+enum class DependencyVerdict {
+    SOLVABLE,
+    UNSOLVABLE,
+    UNDECIDED,
+    INVALID
+};
+
+struct DependencyResult {
+    DependencyVerdict verdict;
+
+    DependencyResult() : verdict(DependencyVerdict::UNDECIDED) {}
+};
+
+// Solvability analysis for direction-locked levels (SolverRules::OWN_DIRECTION).
+// Every tile can only leave the board along its own ray, so tile A depends on
+// tile B when B covers a cell A has to slide through. Peeling off tiles whose
+// ray is clear proves solvability; tiles whose first step is blocked only by
+// other such tiles can never move, which proves unsolvability when one of them
+// sits on the dog's ray. Anything in between
+// needs partial slides and is left to the exhaustive search.
+class BlockerGraph {
+private:
+    int gridSize;
+
+    int stepsToEdge(const Tile& tile, const DirectionVector& vec) const;
+
+public:
+    BlockerGraph(int size = 14);
+
+    // A level without a dog is UNSOLVABLE; one with a tile that does not
+    // fit the board is INVALID.
+    DependencyResult analyze(const PuzzleLevel& level);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#include "ConcurrentHashSet.h"
+
+namespace {
+const size_t MAX_SLOTS = size_t(1) << 24;
+const uint64_t EMPTY = 0;
+}
+
+ConcurrentHashSet::ConcurrentHashSet(size_t expectedStates) : count(0), overflowed(false) {
+    size_t slotCount = 16;
+    while (slotCount < expectedStates * 2 && slotCount < MAX_SLOTS) {
+        slotCount <<= 1;
+    }
+
+    slots.reset(new std::atomic<uint64_t>[slotCount]);
+    for (size_t i = 0; i < slotCount; i++) {
+        slots[i].store(EMPTY, std::memory_order_relaxed);
+    }
+    slotMask = slotCount - 1;
+    maxCount = slotCount / 4 * 3;
+}
+
+bool ConcurrentHashSet::insert(uint64_t hash) {
+    uint64_t key = hash == EMPTY ? 1 : hash;
+    size_t pos = static_cast<size_t>(key) & slotMask;
+
+    while (true) {
+        uint64_t current = slots[pos].load(std::memory_order_relaxed);
+        if (current == key) return false;
+
+        if (current == EMPTY) {
+            if (count.load(std::memory_order_relaxed) >= maxCount) {
+                overflowed.store(true, std::memory_order_relaxed);
+                return false;
+            }
+            if (slots[pos].compare_exchange_strong(current, key, std::memory_order_relaxed)) {
+                count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (current == key) return false;
+        }
+
+        pos = (pos + 1) & slotMask;
+    }
+}
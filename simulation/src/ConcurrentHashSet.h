@@ -0,0 +1,33 @@
+#ifndef CONCURRENT_HASH_SET_H
+#define CONCURRENT_HASH_SET_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Lock-free visited set for parallel searches. Only the 64-bit state hash
+// is stored (hash compaction), so two states whose hashes collide are
+// treated as one; with Zobrist hashes that is negligible at the table sizes
+// the solver uses. Slots are claimed with a compare-and-swap and never
+// removed, and the table does not grow: once it is three-quarters full,
+// insert() fails and full() reports it.
+class ConcurrentHashSet {
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    size_t slotMask;
+    size_t maxCount;
+    std::atomic<size_t> count;
+    std::atomic<bool> overflowed;
+
+public:
+    explicit ConcurrentHashSet(size_t expectedStates);
+
+    // Returns true if the hash was not in the set yet.
+    bool insert(uint64_t hash);
+
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    bool full() const { return overflowed.load(std::memory_order_relaxed); }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "Deadline.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// One thread for the whole process. It sleeps until the earliest pending
+// deadline, raises the flags that are due and drops them.
+class Watchdog {
+private:
+    struct Entry {
+        std::chrono::steady_clock::time_point due;
+        std::shared_ptr<std::atomic<bool>> flag;
+    };
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::map<uint64_t, Entry> pending;
+    uint64_t nextId;
+    bool stopping;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            if (pending.empty()) {
+                wakeup.wait(lock);
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            auto earliest = std::chrono::steady_clock::time_point::max();
+            for (auto it = pending.begin(); it != pending.end();) {
+                if (it->second.due <= now) {
+                    it->second.flag->store(true, std::memory_order_relaxed);
+                    it = pending.erase(it);
+                } else {
+                    earliest = std::min(earliest, it->second.due);
+                    ++it;
+                }
+            }
+            if (!pending.empty()) wakeup.wait_until(lock, earliest);
+        }
+    }
+
+public:
+    Watchdog() : nextId(1), stopping(false), worker(&Watchdog::run, this) {}
+
+    ~Watchdog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeup.notify_one();
+        worker.join();
+    }
+
+    uint64_t arm(std::chrono::steady_clock::time_point due, const std::shared_ptr<std::atomic<bool>>& flag) {
+        uint64_t id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            id = nextId++;
+            pending[id] = Entry{due, flag};
+        }
+        wakeup.notify_one();
+        return id;
+    }
+
+    void disarm(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.erase(id);
+    }
+};
+
+Watchdog& watchdog() {
+    static Watchdog instance;
+    return instance;
+}
+
+}
+
+Deadline::Deadline() : expired(std::make_shared<std::atomic<bool>>(false)), registration(0) {}
+
+Deadline::Deadline(const Deadline& other) : expired(other.expired), registration(0) {}
+
+Deadline& Deadline::operator=(const Deadline& other) {
+    if (this != &other) {
+        cancel();
+        expired = other.expired;
+    }
+    return *this;
+}
+
+Deadline::~Deadline() {
+    cancel();
+}
+
+// A fresh flag per budget, so a watchdog entry left from an earlier budget
+// can never cut the new one short.
+void Deadline::start(int milliseconds) {
+    cancel();
+    expired = std::make_shared<std::atomic<bool>>(false);
+    if (milliseconds <= 0) return;
+
+    auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+    registration = watchdog().arm(due, expired);
+}
+
+void Deadline::cancel() {
+    if (registration == 0) return;
+    watchdog().disarm(registration);
+    registration = 0;
+}
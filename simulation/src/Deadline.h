@@ -0,0 +1,31 @@
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+// Time budget that a search can poll with one relaxed load. start() hands
+// the deadline to a shared watchdog thread, which raises the flag when the
+// time is up, so the search loops never read the clock. Copies share the
+// flag of the original but do not own its registration.
+class Deadline {
+private:
+    std::shared_ptr<std::atomic<bool>> expired;
+    uint64_t registration;
+
+public:
+    Deadline();
+    Deadline(const Deadline& other);
+    Deadline& operator=(const Deadline& other);
+    ~Deadline();
+
+    // Arms a new budget of the given milliseconds; 0 or less never expires.
+    void start(int milliseconds);
+    // Withdraws the budget from the watchdog; passed() keeps its value.
+    void cancel();
+
+    bool passed() const { return expired->load(std::memory_order_relaxed); }
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "PuzzleSolver.h"
+#include "SolverFlags.h"
 #include "Tile.h"
 #include <iostream>
 #include <fstream>
@@ -57,6 +58,8 @@ struct DifficultyMetrics {
     int verticalTiles;
     int solutionLength;
     int solveTimeMs;
+    std::string solvedBy;
+    SolveOutcome outcome;
     std::string difficultyRating;
 };
 
@@ -75,8 +78,15 @@ int main(int argc, char* argv[]) {
     std::cout << std::endl;
     
     std::string inputDir = "../simulation_json";
+    PuzzleSolver solver(14);
+    solver.setMaxDepth(500);
+    solver.setMaxStates(1000000);
     
     for (int i = 1; i < argc; i++) {
+        FlagStatus status = applySolverFlag(solver, argc, argv, i);
+        if (status == FlagStatus::INVALID) return 1;
+        if (status == FlagStatus::APPLIED) continue;
+        
         if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
             inputDir = argv[++i];
         }
@@ -84,9 +94,6 @@ int main(int argc, char* argv[]) {
     
     std::vector<DifficultyMetrics> metrics;
     
-    PuzzleSolver solver(14);
-    solver.setMaxDepth(500);
-    solver.setMaxStates(50000);
     
     std::vector<std::string> levelFiles;
     for (const auto& entry : fs::directory_iterator(inputDir)) {
@@ -162,8 +169,13 @@ int main(int argc, char* argv[]) {
         auto endTime = std::chrono::high_resolution_clock::now();
         
         m.solutionLength = solution.size();
+        m.solvedBy = solver.getLastStats().decidedBy();
+        m.outcome = solver.getLastStats().outcome;
         m.solveTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
-        m.difficultyRating = getDifficultyRating(m.tileCount, m.solutionLength);
+        // Without a solution there is no length to rate, so the outcome
+        // stands in for the rating.
+        m.difficultyRating = m.outcome == SolveOutcome::SOLVED ? getDifficultyRating(m.tileCount, m.solutionLength)
+                                                               : solveOutcomeToString(m.outcome);
         
         metrics.push_back(m);
         
@@ -196,15 +208,40 @@ int main(int argc, char* argv[]) {
     std::cout << std::endl;
     
     double avgTiles = 0, avgMoves = 0;
+    int solvedCount = 0, unsolvableCount = 0, undecidedCount = 0, invalidCount = 0;
     for (const auto& m : metrics) {
         avgTiles += m.tileCount;
-        avgMoves += m.solutionLength;
+        if (m.outcome == SolveOutcome::SOLVED) {
+            avgMoves += m.solutionLength;
+            solvedCount++;
+        } else if (m.outcome == SolveOutcome::UNSOLVABLE) {
+            unsolvableCount++;
+        } else if (m.outcome == SolveOutcome::INVALID_LEVEL) {
+            invalidCount++;
+        } else {
+            undecidedCount++;
+        }
     }
     avgTiles /= metrics.size();
-    avgMoves /= metrics.size();
+    if (solvedCount > 0) avgMoves /= solvedCount;
     
+    std::cout << "Solved: " << solvedCount << ", unsolvable: " << unsolvableCount
+              << ", undecided (limit reached or cancelled): " << undecidedCount << ", invalid: " << invalidCount
+              << std::endl;
     std::cout << "Average tiles per level: " << std::fixed << std::setprecision(1) << avgTiles << std::endl;
-    std::cout << "Average solution length: " << std::fixed << std::setprecision(1) << avgMoves << std::endl;
+    std::cout << "Average solution length (solved levels): " << std::fixed << std::setprecision(1) << avgMoves << std::endl;
+    
+    if (solver.getStrategy() == SolverStrategy::PORTFOLIO) {
+        std::map<std::string, int> wins;
+        for (const auto& m : metrics) {
+            wins[m.solvedBy]++;
+        }
+        std::cout << "Portfolio wins:";
+        for (const auto& [name, count] : wins) {
+            std::cout << " " << name << "=" << count;
+        }
+        std::cout << std::endl;
+    }
     
     std::cout << std::endl;
     
@@ -222,5 +259,6 @@ int main(int argc, char* argv[]) {
         std::cout << "Difficulty progression: GOOD - Tiles increase smoothly across levels" << std::endl;
     }
     
-    return 0;
+    if (unsolvableCount + invalidCount > 0) return 1;
+    return undecidedCount > 0 ? 2 : 0;
 }
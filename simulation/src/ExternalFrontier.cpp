@@ -0,0 +1,220 @@
+#include "ExternalFrontier.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <queue>
+
+namespace fs = std::filesystem;
+
+namespace {
+std::atomic<unsigned> directoryCounter(0);
+
+int compareRecords(const uint8_t* a, const uint8_t* b, size_t recordSize) {
+    uint64_t hashA = ExternalFrontier::recordHash(a);
+    uint64_t hashB = ExternalFrontier::recordHash(b);
+    if (hashA != hashB) return hashA < hashB ? -1 : 1;
+    return std::memcmp(a + sizeof(uint64_t), b + sizeof(uint64_t), recordSize - sizeof(uint64_t));
+}
+}
+
+ExternalFrontier::Reader::Reader(const std::string& path, size_t size)
+    : file(path, std::ios::binary), recordSize(size) {}
+
+bool ExternalFrontier::Reader::next(uint8_t* record) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(record), recordSize));
+}
+
+ExternalFrontier::ExternalFrontier(const std::string& parentDirectory, size_t bytes, size_t states)
+    : stateBytes(bytes), recordSize(bytes + sizeof(uint64_t)), bufferStates(std::max<size_t>(states, 1)),
+      layers(0), storedStates(0), failed(false) {
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path path = fs::path(parentDirectory) /
+                    ("external_bfs_" + std::to_string(stamp) + "_" + std::to_string(directoryCounter++));
+    directory = path.string();
+
+    std::error_code error;
+    fs::create_directories(path, error);
+    if (error) {
+        std::cerr << "Failed to create directory: " << directory << std::endl;
+        failed = true;
+    }
+    buffer.reserve(std::min<size_t>(bufferStates, size_t(1) << 20) * recordSize);
+}
+
+ExternalFrontier::~ExternalFrontier() {
+    std::error_code error;
+    fs::remove_all(directory, error);
+}
+
+uint64_t ExternalFrontier::recordHash(const uint8_t* record) {
+    uint64_t hash;
+    std::memcpy(&hash, record, sizeof(hash));
+    return hash;
+}
+
+std::string ExternalFrontier::layerPath(int depth) const {
+    return directory + "/layer_" + std::to_string(depth) + ".bin";
+}
+
+std::string ExternalFrontier::closedPath() const {
+    return directory + "/closed.bin";
+}
+
+void ExternalFrontier::add(const uint8_t* state, uint64_t hash) {
+    size_t offset = buffer.size();
+    buffer.resize(offset + recordSize);
+    std::memcpy(buffer.data() + offset, &hash, sizeof(hash));
+    std::memcpy(buffer.data() + offset + sizeof(hash), state, stateBytes);
+
+    if (buffer.size() / recordSize >= bufferStates) {
+        spillRun();
+    }
+}
+
+void ExternalFrontier::spillRun() {
+    size_t count = buffer.size() / recordSize;
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    const uint8_t* data = buffer.data();
+    size_t size = recordSize;
+    std::sort(order.begin(), order.end(), [data, size](uint32_t a, uint32_t b) {
+        return compareRecords(data + a * size, data + b * size, size) < 0;
+    });
+
+    std::string path = directory + "/run_" + std::to_string(runs.size()) + ".bin";
+    std::ofstream out(path, std::ios::binary);
+    const uint8_t* last = nullptr;
+    for (uint32_t index : order) {
+        const uint8_t* record = data + index * size;
+        if (last && compareRecords(last, record, size) == 0) continue;
+        out.write(reinterpret_cast<const char*>(record), size);
+        last = record;
+    }
+    if (!out) {
+        std::cerr << "Failed to write file: " << path << std::endl;
+        failed = true;
+    }
+
+    runs.push_back(path);
+    buffer.clear();
+}
+
+// K-way merge of the spilled runs; a record is written once and only when
+// the closed file (every earlier layer) does not hold it.
+size_t ExternalFrontier::mergeRuns(const std::string& outPath) {
+    struct Cursor {
+        Reader reader;
+        std::vector<uint8_t> record;
+    };
+
+    std::vector<Cursor> cursors;
+    cursors.reserve(runs.size());
+    for (const auto& run : runs) {
+        cursors.push_back({Reader(run, recordSize), std::vector<uint8_t>(recordSize)});
+    }
+
+    size_t size = recordSize;
+    auto later = [&cursors, size](size_t a, size_t b) {
+        return compareRecords(cursors[a].record.data(), cursors[b].record.data(), size) > 0;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t i = 0; i < cursors.size(); i++) {
+        if (cursors[i].reader.next(cursors[i].record.data())) heap.push(i);
+    }
+
+    Reader closed(closedPath(), recordSize);
+    std::vector<uint8_t> closedRecord(recordSize);
+    bool closedValid = layers > 0 && closed.next(closedRecord.data());
+
+    std::ofstream out(outPath, std::ios::binary);
+    std::vector<uint8_t> last(recordSize);
+    bool haveLast = false;
+    size_t count = 0;
+
+    while (!heap.empty()) {
+        size_t top = heap.top();
+        heap.pop();
+        const uint8_t* record = cursors[top].record.data();
+
+        if (!haveLast || compareRecords(last.data(), record, size) != 0) {
+            std::memcpy(last.data(), record, size);
+            haveLast = true;
+
+            while (closedValid && compareRecords(closedRecord.data(), record, size) < 0) {
+                closedValid = closed.next(closedRecord.data());
+            }
+            if (!closedValid || compareRecords(closedRecord.data(), record, size) != 0) {
+                out.write(reinterpret_cast<const char*>(record), size);
+                count++;
+            }
+        }
+
+        if (cursors[top].reader.next(cursors[top].record.data())) heap.push(top);
+    }
+
+    if (!out) {
+        std::cerr << "Failed to write file: " << outPath << std::endl;
+        failed = true;
+    }
+    return count;
+}
+
+// The new layer never overlaps the closed file, so a plain two-way merge
+// keeps it sorted and duplicate-free.
+void ExternalFrontier::mergeClosed(const std::string& layer) {
+    std::string merged = directory + "/closed.tmp";
+    {
+        Reader left(closedPath(), recordSize);
+        Reader right(layer, recordSize);
+        std::vector<uint8_t> a(recordSize);
+        std::vector<uint8_t> b(recordSize);
+        bool haveA = layers > 0 && left.next(a.data());
+        bool haveB = right.next(b.data());
+
+        std::ofstream out(merged, std::ios::binary);
+        while (haveA || haveB) {
+            if (haveA && (!haveB || compareRecords(a.data(), b.data(), recordSize) < 0)) {
+                out.write(reinterpret_cast<const char*>(a.data()), recordSize);
+                haveA = left.next(a.data());
+            } else {
+                out.write(reinterpret_cast<const char*>(b.data()), recordSize);
+                haveB = right.next(b.data());
+            }
+        }
+        if (!out) {
+            std::cerr << "Failed to write file: " << merged << std::endl;
+            failed = true;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(merged, closedPath(), error);
+    if (error) failed = true;
+}
+
+size_t ExternalFrontier::finishLayer() {
+    if (!buffer.empty()) spillRun();
+
+    std::string path = layerPath(layers);
+    size_t added = mergeRuns(path);
+
+    std::error_code error;
+    for (const auto& run : runs) {
+        fs::remove(run, error);
+    }
+    runs.clear();
+
+    if (added > 0) mergeClosed(path);
+    layers++;
+    storedStates += added;
+    return failed ? 0 : added;
+}
+
+ExternalFrontier::Reader ExternalFrontier::readLayer(int depth) const {
+    return Reader(layerPath(depth), recordSize);
+}
@@ -0,0 +1,74 @@
+#ifndef EXTERNAL_FRONTIER_H
+#define EXTERNAL_FRONTIER_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+// BFS layers kept on disk for the external-memory search. A record is a
+// state's hash followed by its packed cells; every file holds records sorted
+// by hash, then cells, without duplicates. States of the next layer are
+// collected in a bounded buffer that is sorted and spilled as a run whenever
+// it fills up. finishLayer() merges the runs, drops every state stored in an
+// earlier layer and writes the rest as the next layer, so memory use is the
+// buffer alone no matter how many states the search reaches.
+class ExternalFrontier {
+public:
+    // Sequential reader over one file of records.
+    class Reader {
+    private:
+        std::ifstream file;
+        size_t recordSize;
+
+    public:
+        Reader(const std::string& path, size_t recordSize);
+        bool next(uint8_t* record);
+    };
+
+private:
+    std::string directory;
+    size_t stateBytes;
+    size_t recordSize;
+    size_t bufferStates;
+    std::vector<uint8_t> buffer;
+    std::vector<std::string> runs;
+    int layers;
+    size_t storedStates;
+    bool failed;
+
+    std::string layerPath(int depth) const;
+    std::string closedPath() const;
+    void spillRun();
+    size_t mergeRuns(const std::string& outPath);
+    void mergeClosed(const std::string& layer);
+
+public:
+    // Creates a private directory below parentDirectory, removed again by
+    // the destructor. bufferStates bounds the states held in memory.
+    ExternalFrontier(const std::string& parentDirectory, size_t stateBytes, size_t bufferStates);
+    ~ExternalFrontier();
+
+    ExternalFrontier(const ExternalFrontier&) = delete;
+    ExternalFrontier& operator=(const ExternalFrontier&) = delete;
+
+    // Queues a state for the layer being built.
+    void add(const uint8_t* state, uint64_t hash);
+
+    // Closes the layer being built and returns how many new states it got.
+    size_t finishLayer();
+
+    Reader readLayer(int depth) const;
+
+    // False once a file could not be created or written.
+    bool ok() const { return !failed; }
+    int layerCount() const { return layers; }
+    size_t size() const { return storedStates; }
+    size_t bytesPerRecord() const { return recordSize; }
+
+    static uint64_t recordHash(const uint8_t* record);
+    static const uint8_t* recordState(const uint8_t* record) { return record + sizeof(uint64_t); }
+};
+
+#endif
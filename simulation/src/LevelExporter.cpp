@@ -22,6 +22,9 @@ json LevelExporter::levelToJson(const PuzzleLevel& level) {
     j["type"] = level.type;
     j["unlocked"] = level.unlocked;
     j["timeLimit"] = level.timeLimit;
+    // A string, since JavaScript numbers cannot hold every 64-bit seed.
+    j["seed"] = std::to_string(level.seed);
+    j["attempt"] = level.attempt;
     
     json tilesArray = json::array();
     for (const auto& tile : level.tiles) {
@@ -29,6 +32,14 @@ json LevelExporter::levelToJson(const PuzzleLevel& level) {
     }
     j["tiles"] = tilesArray;
     
+    if (!level.solution.empty()) {
+        json solution = json::array();
+        for (int index : level.solution) {
+            solution.push_back(level.tiles[index].id);
+        }
+        j["solution"] = solution;
+    }
+    
     return j;
 }
 
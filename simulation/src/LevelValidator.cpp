@@ -1,10 +1,13 @@
 #include "PuzzleSolver.h"
+#include "SolverFlags.h"
 #include "Tile.h"
 #include <iostream>
 #include <fstream>
 #include <filesystem>
 #include <chrono>
 #include <iomanip>
+#include <map>
+#include <sstream>
 #include "json.hpp"
 
 using json = nlohmann::json;
@@ -52,6 +55,7 @@ struct ValidationResult {
     bool solvable;
     int tileCount;
     int checkTimeMs;
+    SolverStats stats;
     std::string error;
 };
 
@@ -64,8 +68,15 @@ int main(int argc, char* argv[]) {
     std::string inputDir = "../simulation_json";
     bool regenerate = false;
     int maxRetries = 20;
+    PuzzleSolver solver(14);
+    solver.setMaxDepth(500);
+    solver.setMaxStates(1000000);
     
     for (int i = 1; i < argc; i++) {
+        FlagStatus status = applySolverFlag(solver, argc, argv, i);
+        if (status == FlagStatus::INVALID) return 1;
+        if (status == FlagStatus::APPLIED) continue;
+        
         if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
             inputDir = argv[++i];
         } else if (strcmp(argv[i], "-r") == 0) {
@@ -78,14 +89,18 @@ int main(int argc, char* argv[]) {
     std::cout << "Configuration:" << std::endl;
     std::cout << "  - Input directory: " << inputDir << std::endl;
     std::cout << "  - Max retries for regeneration: " << maxRetries << std::endl;
+    std::cout << "  - Move rules: " << solverRulesToString(solver.getRules()) << std::endl;
+    std::cout << "  - Solver strategy: " << solverStrategyToString(solver.getStrategy()) << std::endl;
+    std::cout << "  - Canonical wolf states: " << (solver.getCanonicalStates() ? "on" : "off") << std::endl;
+    if (solver.getBitstateMemory() > 0) {
+        std::cout << "  - Bitstate visited set: " << solver.getBitstateMemory() << " MB" << std::endl;
+    }
     std::cout << std::endl;
     
     std::vector<ValidationResult> results;
     std::vector<int> unsolvableLevels;
-    
-    PuzzleSolver solver(14);
-    solver.setMaxDepth(500);
-    solver.setMaxStates(50000);
+    std::vector<int> undecidedLevels;
+    std::vector<int> invalidLevels;
     
     std::vector<std::string> levelFiles;
     for (const auto& entry : fs::directory_iterator(inputDir)) {
@@ -148,12 +163,30 @@ int main(int argc, char* argv[]) {
         auto endTime = std::chrono::high_resolution_clock::now();
         
         result.checkTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+        result.stats = solver.getLastStats();
         
+        std::string winner = ", " + solveOutcomeToString(result.stats.outcome);
+        if (solver.getStrategy() == SolverStrategy::PORTFOLIO) {
+            winner += " by " + result.stats.decidedBy();
+        }
+        if (result.stats.bitstate) {
+            std::ostringstream coverage;
+            coverage << std::fixed << std::setprecision(2) << result.stats.bitstateCoverage * 100;
+            winner += ", " + std::to_string(result.stats.bitstateStates) + " states, " + coverage.str() + "% coverage";
+        }
+        
+        // A search that ran out of budget has not shown the level unsolvable.
         if (result.solvable) {
-            std::cout << " SOLVABLE (" << result.checkTimeMs << "ms)" << std::endl;
-        } else {
-            std::cout << " NOT SOLVABLE (" << result.checkTimeMs << "ms)" << std::endl;
+            std::cout << " SOLVABLE (" << result.checkTimeMs << "ms" << winner << ")" << std::endl;
+        } else if (result.stats.outcome == SolveOutcome::INVALID_LEVEL) {
+            std::cout << " INVALID (a tile lies off the board)" << std::endl;
+            invalidLevels.push_back(level.id);
+        } else if (result.stats.outcome == SolveOutcome::UNSOLVABLE) {
+            std::cout << " NOT SOLVABLE (" << result.checkTimeMs << "ms" << winner << ")" << std::endl;
             unsolvableLevels.push_back(level.id);
+        } else {
+            std::cout << " UNDECIDED (" << result.checkTimeMs << "ms" << winner << ")" << std::endl;
+            undecidedLevels.push_back(level.id);
         }
         
         results.push_back(result);
@@ -165,20 +198,28 @@ int main(int argc, char* argv[]) {
     std::cout << "==========================================" << std::endl;
     std::cout << std::endl;
     
-    int solvableCount = 0;
-    int unsolvableCount = 0;
-    
-    for (const auto& result : results) {
-        if (result.solvable) {
-            solvableCount++;
-        } else {
-            unsolvableCount++;
-        }
-    }
+    int unsolvableCount = static_cast<int>(unsolvableLevels.size());
+    int undecidedCount = static_cast<int>(undecidedLevels.size());
+    int invalidCount = static_cast<int>(invalidLevels.size());
+    int solvableCount = static_cast<int>(results.size()) - unsolvableCount - undecidedCount - invalidCount;
     
     std::cout << "Total levels checked: " << results.size() << std::endl;
     std::cout << "Solvable levels: " << solvableCount << std::endl;
     std::cout << "Unsolvable levels: " << unsolvableCount << std::endl;
+    std::cout << "Undecided levels (limit reached or cancelled): " << undecidedCount << std::endl;
+    std::cout << "Invalid levels: " << invalidCount << std::endl;
+    
+    if (solver.getStrategy() == SolverStrategy::PORTFOLIO) {
+        std::map<std::string, int> wins;
+        for (const auto& result : results) {
+            wins[result.stats.decidedBy()]++;
+        }
+        std::cout << "Portfolio wins:";
+        for (const auto& [name, count] : wins) {
+            std::cout << " " << name << "=" << count;
+        }
+        std::cout << std::endl;
+    }
     
     if (!unsolvableLevels.empty()) {
         std::cout << std::endl;
@@ -190,11 +231,36 @@ int main(int argc, char* argv[]) {
         std::cout << std::endl;
     }
     
+    if (!invalidLevels.empty()) {
+        std::cout << std::endl;
+        std::cout << "Invalid level IDs: ";
+        for (size_t i = 0; i < invalidLevels.size(); i++) {
+            if (i > 0) std::cout << ", ";
+            std::cout << invalidLevels[i];
+        }
+        std::cout << std::endl;
+    }
+    
+    if (!undecidedLevels.empty()) {
+        std::cout << std::endl;
+        std::cout << "Undecided level IDs: ";
+        for (size_t i = 0; i < undecidedLevels.size(); i++) {
+            if (i > 0) std::cout << ", ";
+            std::cout << undecidedLevels[i];
+        }
+        std::cout << std::endl;
+    }
+    
     std::cout << std::endl;
     
-    if (unsolvableCount > 0) {
-        std::cout << "ACTION REQUIRED: " << unsolvableCount << " levels need to be regenerated." << std::endl;
+    if (unsolvableCount + invalidCount > 0) {
+        std::cout << "ACTION REQUIRED: " << unsolvableCount + invalidCount << " levels need to be regenerated."
+                  << std::endl;
         return 1;
+    } else if (undecidedCount > 0) {
+        std::cout << "INCONCLUSIVE: " << undecidedCount
+                  << " levels hit the search limits; raise them or try another strategy." << std::endl;
+        return 2;
     } else {
         std::cout << "All levels are solvable!" << std::endl;
         return 0;
@@ -0,0 +1,80 @@
+#include "MoveCache.h"
+
+MoveCache::MoveCache(const LevelDescriptor& level, SolverRules solverRules)
+    : rules(solverRules), entries(level.tileCount()) {
+    reset();
+}
+
+void MoveCache::reset() {
+    for (auto& entry : entries) {
+        entry.valid = false;
+    }
+    undoStack.clear();
+    saved.clear();
+}
+
+void MoveCache::compute(const SearchState& state, int tileIndex) {
+    TileMoves& entry = entries[tileIndex];
+    entry.watched = Bitboard();
+    entry.count = 0;
+    entry.valid = true;
+    if (state.exited(tileIndex)) return;
+
+    int first = 0;
+    int last = 3;
+    if (rules == SolverRules::OWN_DIRECTION) {
+        first = last = static_cast<int>(state.level->shape(tileIndex).direction);
+    }
+
+    int cell = state.cells[tileIndex];
+    for (int dir = first; dir <= last; dir++) {
+        bool exits;
+        Bitboard scanned;
+        int anchor = state.slideAnchor(tileIndex, dir, exits, &scanned);
+        entry.watched |= scanned;
+        if (anchor != cell || exits) {
+            entry.reads[entry.count] = scanned;
+            entry.anchors[entry.count] = static_cast<uint8_t>(anchor);
+            entry.exits[entry.count] = exits;
+            entry.count++;
+        }
+    }
+}
+
+// With keep set the dropped entries are saved for unmakeMove.
+void MoveCache::invalidate(const Bitboard& changed, int movedTile, bool keep) {
+    for (int i = 0; i < static_cast<int>(entries.size()); i++) {
+        TileMoves& entry = entries[i];
+        if (!entry.valid || (i != movedTile && !entry.watched.intersects(changed))) continue;
+
+        if (keep) saved.push_back({i, entry});
+        entry.valid = false;
+    }
+}
+
+void MoveCache::makeMove(SearchState& state, int tileIndex, int newCell) {
+    undoStack.push_back({tileIndex, state.cells[tileIndex], saved.size()});
+
+    Bitboard changed = state.footprint(tileIndex);
+    state.moveTile(tileIndex, newCell);
+    changed |= state.footprint(tileIndex);
+    invalidate(changed, tileIndex, true);
+}
+
+// Entries computed while the move was applied stay valid when they never
+// looked at the cells it touched; the rest are dropped, then the entries
+// saved by makeMove are restored.
+void MoveCache::unmakeMove(SearchState& state) {
+    Undo undo = undoStack.back();
+    undoStack.pop_back();
+
+    Bitboard changed = state.footprint(undo.tileIndex);
+    state.moveTile(undo.tileIndex, undo.fromCell);
+    changed |= state.footprint(undo.tileIndex);
+    invalidate(changed, undo.tileIndex, false);
+
+    while (saved.size() > undo.savedBegin) {
+        entries[saved.back().tileIndex] = saved.back().moves;
+        saved.pop_back();
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef MOVE_CACHE_H
+#define MOVE_CACHE_H
+
+#include "SearchState.h"
+#include "SolverOptions.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Slide results per tile for a state that is walked with make/unmake. Each
+// entry remembers the cells its slides had to test; a move only changes the
+// moved tile's old and new footprint, so only entries watching those cells
+// (and the moved tile's own) are dropped. Unmake puts back the entries that
+// make dropped, so backtracking does not recompute them.
+class MoveCache {
+public:
+    struct TileMoves {
+        Bitboard watched;
+        Bitboard reads[4];
+        uint8_t anchors[4];
+        uint8_t exits[4];
+        uint8_t count;
+        bool valid;
+    };
+
+private:
+    struct Undo {
+        int tileIndex;
+        int fromCell;
+        size_t savedBegin;
+    };
+
+    struct Saved {
+        int tileIndex;
+        TileMoves moves;
+    };
+
+    SolverRules rules;
+    std::vector<TileMoves> entries;
+    std::vector<Undo> undoStack;
+    std::vector<Saved> saved;
+
+    void compute(const SearchState& state, int tileIndex);
+    void invalidate(const Bitboard& changed, int movedTile, bool keep);
+
+public:
+    MoveCache(const LevelDescriptor& level, SolverRules solverRules);
+
+    // Drops everything; needed after the state was changed behind the
+    // cache's back, e.g. by SearchState::assign.
+    void reset();
+
+    // Slides available to a tile in the current state, in direction order.
+    // Each is anchors[k], or an exit when exits[k] is set; reads[k] holds
+    // the cells that slide tested.
+    const TileMoves& moves(const SearchState& state, int tileIndex) {
+        if (!entries[tileIndex].valid) compute(state, tileIndex);
+        return entries[tileIndex];
+    }
+
+    void makeMove(SearchState& state, int tileIndex, int newCell);
+    void unmakeMove(SearchState& state);
+};
+
+#endif
@@ -1,25 +1,26 @@
 #include "PuzzleGenerator.h"
 #include "PuzzleSolver.h"
 #include "Utils.h"
+#include "ThreadPool.h"
 #include <algorithm>
+#include <array>
 #include <iostream>
-#include <set>
-#include <random>
 #include <chrono>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <sstream>
 
 PuzzleGenerator::PuzzleGenerator(int size, int tSize) 
-    : gridSize(size), tileSize(tSize), timeoutSeconds(30), maxRetriesDefault(50) {}
-
-bool PuzzleGenerator::isPositionUsed(const std::vector<Tile>& tiles, int col, int row) {
-    for (const auto& tile : tiles) {
-        if (tile.contains(col, row)) {
-            return true;
-        }
+    : gridSize(size), tileSize(tSize), timeoutSeconds(30), maxRetriesDefault(50),
+      solverRules(SolverRules::ALL_DIRECTIONS), solverStrategy(SolverStrategy::DEFAULT), solverThreads(0),
+      candidateJobs(1), masterSeed(Random::entropySeed()), log(&std::cout) {
+    for (const auto& cell : getAllValidCells(gridSize)) {
+        diamondMask.set(cell.first, cell.second);
     }
-    return false;
 }
 
-bool PuzzleGenerator::canPlaceTile(const std::vector<Tile>& tiles, int col, int row, int colSpan, int rowSpan) {
+bool PuzzleGenerator::canPlaceTile(const Bitboard& occupied, int col, int row, int colSpan, int rowSpan) {
     int right = col + colSpan - 1;
     int bottom = row + rowSpan - 1;
     
@@ -27,23 +28,8 @@ bool PuzzleGenerator::canPlaceTile(const std::vector<Tile>& tiles, int col, int
         return false;
     }
     
-    for (int c = col; c <= right; c++) {
-        for (int r = row; r <= bottom; r++) {
-            if (!isValidDiamondCell(c, r, gridSize) || isPositionUsed(tiles, c, r)) {
-                return false;
-            }
-        }
-    }
-    
-    return true;
-}
-
-void PuzzleGenerator::markUsedPositions(std::set<std::string>& used, int col, int row, int colSpan, int rowSpan) {
-    for (int c = col; c < col + colSpan; c++) {
-        for (int r = row; r < row + rowSpan; r++) {
-            used.insert(std::to_string(c) + "," + std::to_string(r));
-        }
-    }
+    Bitboard footprint = Bitboard::rect(col, row, colSpan, rowSpan);
+    return footprint.isSubsetOf(diamondMask) && !footprint.intersects(occupied);
 }
 
 bool PuzzleGenerator::isValidDiamondCell(int col, int row, int gridSize) {
@@ -127,43 +113,32 @@ DifficultyParams PuzzleGenerator::getDifficultyParams(int levelId) {
     return params;
 }
 
-Direction PuzzleGenerator::getOptimalDogDirection(int dogCol, int dogRow, int gridSize) {
+Direction PuzzleGenerator::getOptimalDogDirection(int dogCol, int dogRow, int gridSize, Random& random) {
     std::vector<Direction> directions = {
         Direction::UP_RIGHT, Direction::UP_LEFT,
         Direction::DOWN_LEFT, Direction::DOWN_RIGHT
     };
     
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 g(seed);
-    std::uniform_int_distribution<> dis(0, 3);
-    
-    return directions[dis(g)];
+    return directions[random.nextInt(0, 3)];
 }
 
-PuzzleLevel PuzzleGenerator::generateLevel(int levelId) {
-    PuzzleLevel level;
-    
-    DifficultyParams params = getDifficultyParams(levelId);
-    level = generateLevelWithParams(levelId, params);
-    
-    level.id = levelId;
-    level.name = "第" + std::to_string(levelId) + "关";
-    level.type = "normal";
-    level.unlocked = (levelId == 1);
-    level.timeLimit = 0;
-    level.stars = 0;
-    level.score = 0;
-    
-    setDogTile(level);
-    
-    return level;
+PuzzleLevel PuzzleGenerator::generateLevel(int levelId, int attempt) {
+    return buildCandidate(levelId, getDifficultyParams(levelId), attempt);
 }
 
-PuzzleLevel PuzzleGenerator::generateLevelWithParams(int levelId, const DifficultyParams& params) {
+// Everything drawn below depends only on the master seed, the level and the
+// attempt. Tile ids come from a second stream, so they never shift the
+// layout draws.
+PuzzleLevel PuzzleGenerator::generateLevelWithParams(int levelId, const DifficultyParams& params, int attempt) {
     PuzzleLevel level;
+    level.seed = masterSeed;
+    level.attempt = attempt;
+    uint64_t seed = Random::deriveSeed(masterSeed, levelId, attempt);
+    Random g(seed);
+    Random ids(Random::mix(seed));
     std::vector<Tile> tiles;
     
-    std::set<std::string> usedPositions;
+    Bitboard occupied;
     
     std::vector<Direction> directions = {
         Direction::UP_RIGHT, Direction::UP_LEFT,
@@ -180,27 +155,25 @@ PuzzleLevel PuzzleGenerator::generateLevelWithParams(int levelId, const Difficul
         allCells.insert(allCells.end(), cells.begin(), cells.end());
     }
     
-    unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-    std::mt19937 g(seed);
     std::shuffle(allCells.begin(), allCells.end(), g);
     
     int dogCol = center;
     int dogRow = center;
     
-    Direction dogDir = getOptimalDogDirection(dogCol, dogRow, gridSize);
+    Direction dogDir = getOptimalDogDirection(dogCol, dogRow, gridSize, g);
     
-    Tile dogTile(dogCol, dogRow, 1, 1, UnitType::DOG, dogDir);
+    Tile dogTile(dogCol, dogRow, 1, 1, UnitType::DOG, dogDir, Utils::generateId(ids));
     tiles.push_back(dogTile);
-    markUsedPositions(usedPositions, dogCol, dogRow, 1, 1);
+    occupied.set(dogCol, dogRow);
     
     const DirectionVector& dogVec = DIRECTION_VECTORS[static_cast<int>(dogDir)];
     int blockerCol = dogCol + dogVec.col;
     int blockerRow = dogRow + dogVec.row;
     
     if (isValidDiamondCell(blockerCol, blockerRow, gridSize)) {
-        Direction blockerDir = directions[Utils::getRandomInt(0, 3)];
-        tiles.push_back(Tile(blockerCol, blockerRow, 1, 1, UnitType::WOLF, blockerDir));
-        markUsedPositions(usedPositions, blockerCol, blockerRow, 1, 1);
+        Direction blockerDir = directions[g.nextInt(0, 3)];
+        tiles.push_back(Tile(blockerCol, blockerRow, 1, 1, UnitType::WOLF, blockerDir, Utils::generateId(ids)));
+        occupied.set(blockerCol, blockerRow);
     }
     
     int tilesToPlace = static_cast<int>(allCells.size() * params.density / 100.0);
@@ -214,45 +187,43 @@ PuzzleLevel PuzzleGenerator::generateLevelWithParams(int levelId, const Difficul
         int col = cell.first;
         int row = cell.second;
         
-        if (usedPositions.count(std::to_string(col) + "," + std::to_string(row))) {
+        if (occupied.test(col, row)) {
             continue;
         }
         
         Direction dir;
         if (params.randomDirections) {
-            dir = directions[Utils::getRandomInt(0, 3)];
+            dir = directions[g.nextInt(0, 3)];
         } else {
             dir = directions[tilesPlaced % 4];
         }
         
-        std::vector<std::pair<int, int>> tileSizes;
-        if (params.maxTileSize >= 3) {
-            tileSizes = {{2, 1}, {1, 2}, {1, 1}};
-        } else if (params.maxTileSize >= 2) {
-            tileSizes = {{2, 1}, {1, 2}, {1, 1}};
-        } else {
-            tileSizes = {{1, 1}};
+        std::array<std::pair<int, int>, 3> tileSizes = {{{2, 1}, {1, 2}, {1, 1}}};
+        int sizeCount = 3;
+        if (params.maxTileSize < 2) {
+            tileSizes[0] = {1, 1};
+            sizeCount = 1;
         }
         
-        std::shuffle(tileSizes.begin(), tileSizes.end(), g);
+        std::shuffle(tileSizes.begin(), tileSizes.begin() + sizeCount, g);
         
         bool placed = false;
-        for (const auto& size : tileSizes) {
-            int colSpan = size.first;
-            int rowSpan = size.second;
+        for (int i = 0; i < sizeCount; i++) {
+            int colSpan = tileSizes[i].first;
+            int rowSpan = tileSizes[i].second;
             
-            if (canPlaceTile(tiles, col, row, colSpan, rowSpan)) {
-                tiles.push_back(Tile(col, row, colSpan, rowSpan, UnitType::WOLF, dir));
-                markUsedPositions(usedPositions, col, row, colSpan, rowSpan);
+            if (canPlaceTile(occupied, col, row, colSpan, rowSpan)) {
+                tiles.push_back(Tile(col, row, colSpan, rowSpan, UnitType::WOLF, dir, Utils::generateId(ids)));
+                occupied |= Bitboard::rect(col, row, colSpan, rowSpan);
                 placed = true;
                 tilesPlaced++;
                 break;
             }
         }
         
-        if (!placed && !usedPositions.count(std::to_string(col) + "," + std::to_string(row))) {
-            tiles.push_back(Tile(col, row, 1, 1, UnitType::WOLF, dir));
-            markUsedPositions(usedPositions, col, row, 1, 1);
+        if (!placed && !occupied.test(col, row)) {
+            tiles.push_back(Tile(col, row, 1, 1, UnitType::WOLF, dir, Utils::generateId(ids)));
+            occupied.set(col, row);
             tilesPlaced++;
         }
     }
@@ -261,62 +232,217 @@ PuzzleLevel PuzzleGenerator::generateLevelWithParams(int levelId, const Difficul
     return level;
 }
 
+Bitboard PuzzleGenerator::exitSweep(int col, int row, int colSpan, int rowSpan, Direction dir) {
+    const DirectionVector& vec = DIRECTION_VECTORS[static_cast<int>(dir)];
+    Bitboard sweep;
+    
+    for (col += vec.col, row += vec.row;
+         col >= 1 && row >= 1 && col + colSpan - 1 <= gridSize && row + rowSpan - 1 <= gridSize;
+         col += vec.col, row += vec.row) {
+        sweep |= Bitboard::rect(col, row, colSpan, rowSpan);
+    }
+    return sweep;
+}
+
+// The chain can run out of cells before it reaches minMoves, so short
+// levels are rebuilt from the following attempts; the longest is kept.
+PuzzleLevel PuzzleGenerator::generateConstructiveLevel(int levelId, int attempt) {
+    DifficultyParams params = getDifficultyParams(levelId);
+    PuzzleLevel level;
+    
+    for (int retry = 0; retry < maxRetriesDefault; retry++) {
+        PuzzleLevel candidate = generateConstructiveLevelWithParams(levelId, params, attempt + retry);
+        if (retry == 0 || candidate.solution.size() > level.solution.size()) {
+            level = candidate;
+        }
+        if (static_cast<int>(level.solution.size()) >= params.minMoves) break;
+    }
+    
+    if (static_cast<int>(level.solution.size()) < params.minMoves) {
+        *log << "Warning: Constructive level " << levelId << " has a " << level.solution.size()
+                  << "-move solution, below the " << params.minMoves << " moves its difficulty asks for" << std::endl;
+    }
+    
+    finishLevel(level, levelId);
+    return level;
+}
+
+// Builds the level backwards from its solution. Wolves are added in reverse
+// order of leaving, each with a clear way off the board past every tile
+// already placed, so removing them newest first and then the dog always
+// works. Chain wolves sit across the way out of an earlier chain tile,
+// preferably the latest, which forces the order; filler wolves stay off
+// every chain tile's way out and are never in the way.
+PuzzleLevel PuzzleGenerator::generateConstructiveLevelWithParams(int levelId, const DifficultyParams& params,
+                                                                 int attempt) {
+    PuzzleLevel level;
+    level.seed = masterSeed;
+    level.attempt = attempt;
+    uint64_t seed = Random::deriveSeed(masterSeed, levelId, attempt);
+    Random g(seed);
+    Random ids(Random::mix(seed));
+    
+    std::vector<Direction> directions = {
+        Direction::UP_RIGHT, Direction::UP_LEFT,
+        Direction::DOWN_LEFT, Direction::DOWN_RIGHT
+    };
+    
+    int center = (gridSize + 1) / 2;
+    int startRow = (gridSize - params.effectiveGridSize) / 2 + 1;
+    int endRow = startRow + params.effectiveGridSize - 1;
+    
+    std::vector<std::pair<int, int>> allCells;
+    for (int row = startRow; row <= endRow; row++) {
+        auto cells = getValidCellsInRow(row, gridSize);
+        allCells.insert(allCells.end(), cells.begin(), cells.end());
+    }
+    
+    std::shuffle(allCells.begin(), allCells.end(), g);
+    
+    Direction dogDir = getOptimalDogDirection(center, center, gridSize, g);
+    level.tiles.push_back(Tile(center, center, 1, 1, UnitType::DOG, dogDir, Utils::generateId(ids)));
+    
+    Bitboard occupied;
+    occupied.set(center, center);
+    Bitboard latest = exitSweep(center, center, 1, 1, dogDir);
+    Bitboard reserved = latest;
+    
+    std::array<std::pair<int, int>, 3> tileSizes = {{{2, 1}, {1, 2}, {1, 1}}};
+    int sizeCount = 3;
+    if (params.maxTileSize < 2) {
+        tileSizes[0] = {1, 1};
+        sizeCount = 1;
+    }
+    
+    // Places a wolf on the first free cell, in shuffled order, where
+    // accept(footprint, sweep) holds.
+    auto placeWolf = [&](const auto& accept) {
+        for (const auto& cell : allCells) {
+            if (occupied.test(cell.first, cell.second)) continue;
+            
+            int first = params.randomDirections ? g.nextInt(0, 3) : static_cast<int>(level.tiles.size()) % 4;
+            std::shuffle(tileSizes.begin(), tileSizes.begin() + sizeCount, g);
+            
+            for (int d = 0; d < 4; d++) {
+                Direction dir = directions[(first + d) % 4];
+                for (int i = 0; i < sizeCount; i++) {
+                    int colSpan = tileSizes[i].first;
+                    int rowSpan = tileSizes[i].second;
+                    if (!canPlaceTile(occupied, cell.first, cell.second, colSpan, rowSpan)) continue;
+                    
+                    Bitboard footprint = Bitboard::rect(cell.first, cell.second, colSpan, rowSpan);
+                    Bitboard sweep = exitSweep(cell.first, cell.second, colSpan, rowSpan, dir);
+                    if (!accept(footprint, sweep)) continue;
+                    
+                    level.tiles.push_back(
+                        Tile(cell.first, cell.second, colSpan, rowSpan, UnitType::WOLF, dir, Utils::generateId(ids)));
+                    occupied |= footprint;
+                    latest = sweep;
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+    
+    auto blocking = [&](const Bitboard& target) {
+        return [&occupied, target](const Bitboard& footprint, const Bitboard& sweep) {
+            return footprint.intersects(target) && !sweep.intersects(occupied);
+        };
+    };
+    
+    int chainLength = g.nextInt(std::max(params.minMoves, 1), std::max({params.maxMoves, params.minMoves, 1})) - 1;
+    for (int i = 0; i < chainLength; i++) {
+        if (!placeWolf(blocking(latest)) && !placeWolf(blocking(reserved))) break;
+        reserved |= latest;
+    }
+    
+    for (int chain = static_cast<int>(level.tiles.size()) - 1; chain >= 0; chain--) {
+        level.solution.push_back(chain);
+    }
+    
+    int tilesToPlace = static_cast<int>(allCells.size() * params.density / 100.0);
+    auto clearOfChain = [&reserved](const Bitboard& footprint, const Bitboard&) {
+        return !footprint.intersects(reserved);
+    };
+    while (static_cast<int>(level.tiles.size()) < tilesToPlace && placeWolf(clearOfChain)) {
+    }
+    
+    return level;
+}
+
 PuzzleLevel PuzzleGenerator::generateSolvableLevel(int levelId, int maxRetries) {
+    PuzzleSolver prototype(gridSize);
+    prototype.setTimeout(10);
+    prototype.setRules(solverRules);
+    prototype.setStrategy(solverStrategy);
+    prototype.setThreads(solverThreads);
+    return generateSolvableLevel(levelId, maxRetries, prototype);
+}
+
+PuzzleLevel PuzzleGenerator::generateSolvableLevel(int levelId, int maxRetries, const PuzzleSolver& prototype) {
     DifficultyParams params = getDifficultyParams(levelId);
-    PuzzleSolver solver(gridSize);
+    PuzzleSolver solver(prototype);
     
     solver.setMaxDepth(500);
     solver.setMaxStates(50000);
-    solver.setTimeout(10);
     
     PuzzleLevel lastLevel;
     auto startTime = std::chrono::high_resolution_clock::now();
     int actualRetries = (maxRetries > 0) ? maxRetries : maxRetriesDefault;
     
-    for (int attempt = 0; attempt < actualRetries; attempt++) {
+    if (candidateJobs != 1) {
+        std::vector<DifficultyParams> attemptParams;
+        for (int attempt = 0; attempt < actualRetries; attempt++) {
+            if (attempt > 0 && attempt % 5 == 0) params = degradeDifficulty(params, attempt);
+            attemptParams.push_back(params);
+        }
+        
+        PuzzleLevel winner;
+        int attempt = findSolvableCandidate(levelId, attemptParams, solver, winner);
+        if (attempt >= 0) {
+            auto duration = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::high_resolution_clock::now() - startTime).count();
+            *log << "Level " << levelId << " generated and verified solvable (attempt " << (attempt + 1)
+                      << ", time: " << duration << "s)" << std::endl;
+            return winner;
+        }
+    }
+    
+    for (int attempt = 0; candidateJobs == 1 && attempt < actualRetries; attempt++) {
         auto currentTime = std::chrono::high_resolution_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(currentTime - startTime).count();
         
         if (elapsed >= timeoutSeconds) {
-            std::cout << "Level " << levelId << " generation timed out after " << elapsed << " seconds" << std::endl;
+            *log << "Level " << levelId << " generation timed out after " << elapsed << " seconds" << std::endl;
             break;
         }
         
         if (attempt > 0 && attempt % 5 == 0) {
             params = degradeDifficulty(params, attempt);
-            std::cout << "  Degrading difficulty for level " << levelId << " (attempt " << (attempt + 1) << ")" << std::endl;
+            *log << "  Degrading difficulty for level " << levelId << " (attempt " << (attempt + 1) << ")" << std::endl;
         }
         
-        PuzzleLevel level = generateLevelWithParams(levelId, params);
-        
-        level.id = levelId;
-        level.name = "第" + std::to_string(levelId) + "关";
-        level.type = "normal";
-        level.unlocked = (levelId == 1);
-        level.timeLimit = 0;
-        level.stars = 0;
-        level.score = 0;
-        
-        setDogTile(level);
+        PuzzleLevel level = buildCandidate(levelId, params, attempt);
         lastLevel = level;
         
         if (validateLevel(level)) {
             if (solver.isSolvable(level)) {
                 auto endTime = std::chrono::high_resolution_clock::now();
                 auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count();
-                std::cout << "Level " << levelId << " generated and verified solvable (attempt " << (attempt + 1) 
+                *log << "Level " << levelId << " generated and verified solvable (attempt " << (attempt + 1) 
                           << ", time: " << duration << "s)" << std::endl;
                 return level;
             }
         }
         
         if (attempt % 10 == 9) {
-            std::cout << "Level " << levelId << " attempt " << (attempt + 1) << " not solvable, continuing..." << std::endl;
+            *log << "Level " << levelId << " attempt " << (attempt + 1) << " not solvable, continuing..." << std::endl;
         }
     }
     
-    std::cout << "Warning: Could not generate solvable level " << levelId << " after " << actualRetries << " attempts." << std::endl;
-    std::cout << "  Creating simplified level as fallback..." << std::endl;
+    *log << "Warning: Could not generate solvable level " << levelId << " after " << actualRetries << " attempts." << std::endl;
+    *log << "  Creating simplified level as fallback..." << std::endl;
     
     DifficultyParams simpleParams;
     simpleParams.effectiveGridSize = 6;
@@ -326,7 +452,7 @@ PuzzleLevel PuzzleGenerator::generateSolvableLevel(int levelId, int maxRetries)
     simpleParams.minMoves = 1;
     simpleParams.maxMoves = 3;
     
-    PuzzleLevel simpleLevel = generateLevelWithParams(levelId, simpleParams);
+    PuzzleLevel simpleLevel = generateLevelWithParams(levelId, simpleParams, actualRetries);
     simpleLevel.id = levelId;
     simpleLevel.name = "第" + std::to_string(levelId) + "关";
     simpleLevel.type = "normal";
@@ -336,6 +462,89 @@ PuzzleLevel PuzzleGenerator::generateSolvableLevel(int levelId, int maxRetries)
     return simpleLevel;
 }
 
+PuzzleLevel PuzzleGenerator::buildCandidate(int levelId, const DifficultyParams& params, int attempt) {
+    PuzzleLevel level = generateLevelWithParams(levelId, params, attempt);
+    finishLevel(level, levelId);
+    return level;
+}
+
+void PuzzleGenerator::finishLevel(PuzzleLevel& level, int levelId) {
+    level.id = levelId;
+    level.name = "第" + std::to_string(levelId) + "关";
+    level.type = "normal";
+    level.unlocked = (levelId == 1);
+    level.timeLimit = 0;
+    level.stars = 0;
+    level.score = 0;
+    
+    setDogTile(level);
+}
+
+// Speculative form of the retry loop: workers claim attempts in index order
+// and solve them concurrently. When an attempt proves solvable, every
+// higher attempt is cancelled, while lower ones still run to the end, so the
+// winner is the lowest solvable attempt, as in the sequential loop. Returns
+// that attempt, or -1.
+int PuzzleGenerator::findSolvableCandidate(int levelId, const std::vector<DifficultyParams>& attemptParams,
+                                           const PuzzleSolver& prototype, PuzzleLevel& winner) {
+    int attempts = static_cast<int>(attemptParams.size());
+    int jobs = candidateJobs > 0 ? candidateJobs : ThreadPool::hardwareThreads();
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    std::vector<StopToken> tokens(attempts);
+    std::atomic<int> nextAttempt(0);
+    std::atomic<int> best(attempts);
+    std::mutex mutex;
+    
+    ThreadPool pool(std::min(jobs, std::max(attempts, 1)));
+    std::vector<std::future<void>> done;
+    for (int w = 0; w < pool.size(); w++) {
+        done.push_back(pool.submit([&] {
+            PuzzleSolver solver(prototype);
+            
+            while (true) {
+                int attempt = nextAttempt.fetch_add(1);
+                if (attempt >= attempts || attempt > best.load()) break;
+                
+                auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+                    std::chrono::high_resolution_clock::now() - startTime).count();
+                if (elapsed >= timeoutSeconds) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    *log << "Level " << levelId << " generation timed out after " << elapsed << " seconds" << std::endl;
+                    nextAttempt = attempts;
+                    break;
+                }
+                
+                PuzzleLevel level = buildCandidate(levelId, attemptParams[attempt], attempt);
+                std::ostringstream failure;
+                if (!validateLevel(level, failure)) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    *log << failure.str();
+                    continue;
+                }
+                
+                solver.setStopToken(tokens[attempt]);
+                if (!solver.isSolvable(level)) continue;
+                
+                std::lock_guard<std::mutex> lock(mutex);
+                if (attempt < best.load()) {
+                    best = attempt;
+                    winner = level;
+                    setDogTile(winner);
+                    for (int later = attempt + 1; later < attempts; later++) {
+                        tokens[later].requestStop();
+                    }
+                }
+            }
+        }));
+    }
+    
+    for (auto& task : done) {
+        task.get();
+    }
+    return best.load() < attempts ? best.load() : -1;
+}
+
 DifficultyParams PuzzleGenerator::degradeDifficulty(const DifficultyParams& params, int attemptCount) {
     DifficultyParams degraded = params;
     
@@ -360,6 +569,34 @@ void PuzzleGenerator::setMaxRetries(int retries) {
     maxRetriesDefault = retries;
 }
 
+void PuzzleGenerator::setLog(std::ostream& out) {
+    log = &out;
+}
+
+void PuzzleGenerator::setSolverRules(SolverRules rules) {
+    solverRules = rules;
+}
+
+void PuzzleGenerator::setSolverStrategy(SolverStrategy strategy) {
+    solverStrategy = strategy;
+}
+
+void PuzzleGenerator::setSolverThreads(int threads) {
+    solverThreads = threads;
+}
+
+void PuzzleGenerator::setCandidateJobs(int jobs) {
+    candidateJobs = jobs;
+}
+
+void PuzzleGenerator::setSeed(uint64_t seed) {
+    masterSeed = seed;
+}
+
+uint64_t PuzzleGenerator::getSeed() const {
+    return masterSeed;
+}
+
 PuzzleLevel PuzzleGenerator::generateLevel1() {
     return generateLevel(1);
 }
@@ -386,22 +623,28 @@ void PuzzleGenerator::setDogTile(PuzzleLevel& level) {
 }
 
 bool PuzzleGenerator::validateLevel(const PuzzleLevel& level) {
+    return validateLevel(level, *log);
+}
+
+bool PuzzleGenerator::validateLevel(const PuzzleLevel& level, std::ostream& out) {
     if (level.tiles.empty()) {
-        std::cout << "Validation failed: No tiles in level" << std::endl;
+        out << "Validation failed: No tiles in level" << std::endl;
         return false;
     }
     
-    std::set<std::string> used;
+    Bitboard used;
     
+    // Cells off the bitboard cannot be on the diamond either; the grid check
+    // below rejects them.
     for (const auto& tile : level.tiles) {
         for (int c = tile.gridCol; c < tile.gridCol + tile.gridColSpan; c++) {
             for (int r = tile.gridRow; r < tile.gridRow + tile.gridRowSpan; r++) {
-                std::string key = std::to_string(c) + "," + std::to_string(r);
-                if (used.count(key)) {
-                    std::cout << "Validation failed: Overlapping tiles at " << key << std::endl;
+                if (!Utils::isInGridBounds(c, r, Bitboard::MAX_GRID_SIZE)) continue;
+                if (used.test(c, r)) {
+                    out << "Validation failed: Overlapping tiles at " << c << "," << r << std::endl;
                     return false;
                 }
-                used.insert(key);
+                used.set(c, r);
             }
         }
     }
@@ -415,7 +658,7 @@ bool PuzzleGenerator::validateLevel(const PuzzleLevel& level) {
     }
     
     if (!hasDog) {
-        std::cout << "Validation failed: No dog tile found" << std::endl;
+        out << "Validation failed: No dog tile found" << std::endl;
         return false;
     }
     
@@ -423,7 +666,7 @@ bool PuzzleGenerator::validateLevel(const PuzzleLevel& level) {
         for (int c = tile.gridCol; c < tile.gridCol + tile.gridColSpan; c++) {
             for (int r = tile.gridRow; r < tile.gridRow + tile.gridRowSpan; r++) {
                 if (!isValidDiamondCell(c, r, gridSize)) {
-                    std::cout << "Validation failed: Tile at (" << c << "," << r << ") is outside diamond grid" << std::endl;
+                    out << "Validation failed: Tile at (" << c << "," << r << ") is outside diamond grid" << std::endl;
                     return false;
                 }
             }
@@ -441,7 +684,7 @@ ValidationReport PuzzleGenerator::validateLevelWithReport(const PuzzleLevel& lev
     report.allCellsCovered = true;
     report.noOverlaps = true;
     
-    std::set<std::string> used;
+    Bitboard used;
     int dogTiles = 0;
     int wolfTiles = 0;
     
@@ -455,13 +698,13 @@ ValidationReport PuzzleGenerator::validateLevelWithReport(const PuzzleLevel& lev
         
         for (int c = tile.gridCol; c < tile.gridCol + tile.gridColSpan; c++) {
             for (int r = tile.gridRow; r < tile.gridRow + tile.gridRowSpan; r++) {
-                std::string key = std::to_string(c) + "," + std::to_string(r);
-                if (used.count(key)) {
+                if (!Utils::isInGridBounds(c, r, Bitboard::MAX_GRID_SIZE)) continue;
+                if (used.test(c, r)) {
                     report.noOverlaps = false;
-                    report.overlapPositions.push_back(key);
+                    report.overlapPositions.push_back(std::to_string(c) + "," + std::to_string(r));
                     report.isValid = false;
                 }
-                used.insert(key);
+                used.set(c, r);
             }
         }
     }
@@ -471,10 +714,9 @@ ValidationReport PuzzleGenerator::validateLevelWithReport(const PuzzleLevel& lev
     
     auto allCells = getAllValidCells(gridSize);
     for (const auto& cell : allCells) {
-        std::string key = std::to_string(cell.first) + "," + std::to_string(cell.second);
-        if (used.find(key) == used.end()) {
+        if (!used.test(cell.first, cell.second)) {
             report.allCellsCovered = false;
-            report.uncoveredCells.push_back(key);
+            report.uncoveredCells.push_back(std::to_string(cell.first) + "," + std::to_string(cell.second));
         }
     }
     
@@ -497,6 +739,9 @@ ValidationReport PuzzleGenerator::validateLevelWithReport(const PuzzleLevel& lev
 
 bool PuzzleGenerator::checkLevelSolvability(const PuzzleLevel& level) {
     PuzzleSolver solver(gridSize);
+    solver.setRules(solverRules);
+    solver.setStrategy(solverStrategy);
+    solver.setThreads(solverThreads);
     return solver.isSolvable(level);
 }
 
@@ -515,7 +760,7 @@ PuzzleLevel PuzzleGenerator::generateLevelWithGridSize(int levelId, int effectiv
     params.minMoves = 1;
     params.maxMoves = 10;
     
-    return generateLevelWithParams(levelId, params);
+    return generateLevelWithParams(levelId, params, 0);
 }
 
 PuzzleLevel PuzzleGenerator::generateLevelByDifficulty(int levelId, int maxTileSize, int density, bool randomDirections) {
@@ -528,41 +773,41 @@ PuzzleLevel PuzzleGenerator::generateLevelByDifficulty(int levelId, int maxTileS
     params.minMoves = 1;
     params.maxMoves = 10;
     
-    return generateLevelWithParams(levelId, params);
+    return generateLevelWithParams(levelId, params, 0);
 }
 
-void PuzzleGenerator::printValidationReport(const ValidationReport& report) {
-    std::cout << "\n=== Validation Report ===" << std::endl;
-    std::cout << "Valid: " << (report.isValid ? "YES" : "NO") << std::endl;
-    std::cout << "Total tiles: " << report.tileCount << std::endl;
-    std::cout << "Dog tiles: " << report.dogTileCount << std::endl;
-    std::cout << "Wolf tiles: " << report.wolfTileCount << std::endl;
-    std::cout << "Has dog: " << (report.hasDog ? "YES" : "NO") << std::endl;
-    std::cout << "All cells covered: " << (report.allCellsCovered ? "YES" : "NO") << std::endl;
-    std::cout << "No overlaps: " << (report.noOverlaps ? "YES" : "NO") << std::endl;
+void PuzzleGenerator::printValidationReport(const ValidationReport& report, std::ostream& out) {
+    out << "\n=== Validation Report ===" << std::endl;
+    out << "Valid: " << (report.isValid ? "YES" : "NO") << std::endl;
+    out << "Total tiles: " << report.tileCount << std::endl;
+    out << "Dog tiles: " << report.dogTileCount << std::endl;
+    out << "Wolf tiles: " << report.wolfTileCount << std::endl;
+    out << "Has dog: " << (report.hasDog ? "YES" : "NO") << std::endl;
+    out << "All cells covered: " << (report.allCellsCovered ? "YES" : "NO") << std::endl;
+    out << "No overlaps: " << (report.noOverlaps ? "YES" : "NO") << std::endl;
     
     if (!report.errors.empty()) {
-        std::cout << "\nErrors:" << std::endl;
+        out << "\nErrors:" << std::endl;
         for (const auto& error : report.errors) {
-            std::cout << "  - " << error << std::endl;
+            out << "  - " << error << std::endl;
         }
     }
     
     if (!report.warnings.empty()) {
-        std::cout << "\nWarnings:" << std::endl;
+        out << "\nWarnings:" << std::endl;
         for (const auto& warning : report.warnings) {
-            std::cout << "  - " << warning << std::endl;
+            out << "  - " << warning << std::endl;
         }
     }
     
     if (!report.uncoveredCells.empty() && report.uncoveredCells.size() <= 10) {
-        std::cout << "\nUncovered cells:" << std::endl;
+        out << "\nUncovered cells:" << std::endl;
         for (const auto& cell : report.uncoveredCells) {
-            std::cout << "  - " << cell << std::endl;
+            out << "  - " << cell << std::endl;
         }
     } else if (report.uncoveredCells.size() > 10) {
-        std::cout << "\nUncovered cells: " << report.uncoveredCells.size() << " cells" << std::endl;
+        out << "\nUncovered cells: " << report.uncoveredCells.size() << " cells" << std::endl;
     }
     
-    std::cout << "========================\n" << std::endl;
+    out << "========================\n" << std::endl;
 }
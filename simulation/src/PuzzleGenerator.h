@@ -2,9 +2,13 @@
 #define PUZZLE_GENERATOR_H
 
 #include "Tile.h"
+#include "Bitboard.h"
+#include "SolverOptions.h"
+#include "Random.h"
+#include <cstdint>
 #include <vector>
 #include <string>
-#include <set>
+#include <iostream>
 
 struct DifficultyParams {
     int effectiveGridSize;
@@ -36,6 +40,8 @@ struct ValidationReport {
                          hasDog(false), allCellsCovered(false), noOverlaps(true) {}
 };
 
+class PuzzleSolver;
+
 struct PuzzleLevel {
     int id;
     std::string name;
@@ -46,8 +52,16 @@ struct PuzzleLevel {
     bool unlocked;
     int stars;
     int score;
+    // Master seed and retry the level was drawn from; rerunning the
+    // generator with that seed and the same settings rebuilds it.
+    uint64_t seed;
+    int attempt;
+    // Tile indices in an order in which each tile can slide off the board
+    // along its own direction, ending with the dog; set when the level was
+    // built constructively, empty otherwise.
+    std::vector<int> solution;
     
-    PuzzleLevel() : id(0), timeLimit(0), dogTile(nullptr), unlocked(false), stars(0), score(0) {}
+    PuzzleLevel() : id(0), timeLimit(0), dogTile(nullptr), unlocked(false), stars(0), score(0), seed(0), attempt(0) {}
 };
 
 class PuzzleGenerator {
@@ -56,23 +70,44 @@ private:
     int tileSize;
     int timeoutSeconds;
     int maxRetriesDefault;
+    SolverRules solverRules;
+    SolverStrategy solverStrategy;
+    int solverThreads;
+    int candidateJobs;
+    uint64_t masterSeed;
+    std::ostream* log;
+    Bitboard diamondMask;
     
-    bool isPositionUsed(const std::vector<Tile>& tiles, int col, int row);
-    bool canPlaceTile(const std::vector<Tile>& tiles, int col, int row, int colSpan, int rowSpan);
-    void markUsedPositions(std::set<std::string>& used, int col, int row, int colSpan, int rowSpan);
+    bool canPlaceTile(const Bitboard& occupied, int col, int row, int colSpan, int rowSpan);
     std::vector<std::pair<int, int>> getValidCellsInRow(int row, int gridSize);
     std::vector<std::pair<int, int>> getAllValidCells(int gridSize);
     bool isValidDiamondCell(int col, int row, int gridSize);
     DifficultyParams getDifficultyParams(int levelId);
-    Direction getOptimalDogDirection(int dogCol, int dogRow, int gridSize);
-    PuzzleLevel generateLevelWithParams(int levelId, const DifficultyParams& params);
+    Direction getOptimalDogDirection(int dogCol, int dogRow, int gridSize, Random& random);
+    PuzzleLevel generateLevelWithParams(int levelId, const DifficultyParams& params, int attempt);
+    PuzzleLevel generateConstructiveLevelWithParams(int levelId, const DifficultyParams& params, int attempt);
+    Bitboard exitSweep(int col, int row, int colSpan, int rowSpan, Direction dir);
+    void finishLevel(PuzzleLevel& level, int levelId);
     DifficultyParams degradeDifficulty(const DifficultyParams& params, int attemptCount);
+    PuzzleLevel buildCandidate(int levelId, const DifficultyParams& params, int attempt);
+    int findSolvableCandidate(int levelId, const std::vector<DifficultyParams>& attemptParams,
+                              const PuzzleSolver& prototype, PuzzleLevel& winner);
     
 public:
     PuzzleGenerator(int size = 14, int tSize = 18);
     
-    PuzzleLevel generateLevel(int levelId);
+    // Attempt n of a level is drawn from Random::deriveSeed(seed, id, n), so
+    // a level can be regenerated from the master seed and its attempt.
+    PuzzleLevel generateLevel(int levelId, int attempt = 0);
+    // Solvable by construction: the level carries a known solution and
+    // needs no search. Up to maxRetries attempts from `attempt` on are
+    // built until the solution reaches the difficulty's minMoves.
+    PuzzleLevel generateConstructiveLevel(int levelId, int attempt = 0);
     PuzzleLevel generateSolvableLevel(int levelId, int maxRetries = 50);
+    // Checks candidates with a copy of prototype, keeping its rules, strategy,
+    // time budget and memory settings; only the depth and state caps are
+    // the generator's own.
+    PuzzleLevel generateSolvableLevel(int levelId, int maxRetries, const PuzzleSolver& prototype);
     std::vector<Tile> generateTiles();
     PuzzleLevel generateLevel1();
     PuzzleLevel generateLevel2();
@@ -84,11 +119,25 @@ public:
     void setDogTile(PuzzleLevel& level);
     void setTimeout(int seconds);
     void setMaxRetries(int retries);
+    // Progress and validation messages go here instead of std::cout; the
+    // stream must outlive the generation calls that write to it.
+    void setLog(std::ostream& out);
+    void setSolverRules(SolverRules rules);
+    void setSolverStrategy(SolverStrategy strategy);
+    void setSolverThreads(int threads);
+    // Candidates generateSolvableLevel generates and solves at once; 0 uses
+    // all cores. The lowest solvable attempt always wins, as when run
+    // one at a time.
+    void setCandidateJobs(int jobs);
+    // Defaults to an entropy seed, so unseeded runs still report theirs.
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const;
     
     bool validateLevel(const PuzzleLevel& level);
+    bool validateLevel(const PuzzleLevel& level, std::ostream& out);
     ValidationReport validateLevelWithReport(const PuzzleLevel& level);
     bool checkLevelSolvability(const PuzzleLevel& level);
-    void printValidationReport(const ValidationReport& report);
+    void printValidationReport(const ValidationReport& report, std::ostream& out = std::cout);
 };
 
 #endif
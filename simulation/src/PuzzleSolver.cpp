@@ -1,19 +1,33 @@
 #include "PuzzleSolver.h"
+#include "BlockerGraph.h"
+#include "ConcurrentHashSet.h"
+#include "ShardedStateTable.h"
+#include "ThreadPool.h"
 #include "Utils.h"
 #include <algorithm>
 #include <functional>
 #include <iostream>
 #include <chrono>
+#include <atomic>
+#include <climits>
+#include <deque>
+#include <filesystem>
+#include <queue>
+#include <thread>
 
-PuzzleSolver::PuzzleSolver(int size) : gridSize(size), maxDepth(1000), maxStates(100000), timeoutSeconds(10), shouldTerminate(false) {}
+PuzzleSolver::PuzzleSolver(int size) : gridSize(size), maxDepth(1000), maxStates(100000), timeoutMs(10000),
+                                       rules(SolverRules::ALL_DIRECTIONS), strategy(SolverStrategy::DEFAULT),
+                                       threadCount(0), canonicalStates(false), bitstateMegabytes(0),
+                                       transpositionMegabytes(64), shouldTerminate(false), limitReached(false) {}
+
+// Two relaxed loads: the deadline flag is raised by the watchdog thread,
+// so this is cheap enough to call on every node.
+bool PuzzleSolver::timeExpired() const {
+    return stopToken.stopRequested() || deadline.passed();
+}
 
 bool PuzzleSolver::checkTimeout() {
-    if (timeoutSeconds <= 0) return false;
-    
-    auto currentTime = std::chrono::high_resolution_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(currentTime - startTime).count();
-    
-    if (elapsed >= timeoutSeconds) {
+    if (timeExpired()) {
         shouldTerminate = true;
         return true;
     }
@@ -21,272 +35,1235 @@ bool PuzzleSolver::checkTimeout() {
 }
 
 void PuzzleSolver::setTimeout(int seconds) {
-    timeoutSeconds = seconds;
+    timeoutMs = seconds * 1000;
+}
+
+void PuzzleSolver::setTimeoutMs(int milliseconds) {
+    timeoutMs = milliseconds;
+}
+
+int PuzzleSolver::firstDirection(const SearchState& state, int tileIndex) const {
+    return rules == SolverRules::OWN_DIRECTION ? static_cast<int>(state.level->shape(tileIndex).direction) : 0;
+}
+
+int PuzzleSolver::lastDirection(const SearchState& state, int tileIndex) const {
+    return rules == SolverRules::OWN_DIRECTION ? static_cast<int>(state.level->shape(tileIndex).direction) : 3;
+}
+
+bool PuzzleSolver::canSlideTile(const SearchState& state, int tileIndex,
+                                Direction dir, int& newCol, int& newRow, bool& willDisappear) {
+    int anchor = state.slideAnchor(tileIndex, static_cast<int>(dir), willDisappear);
+    newCol = LevelDescriptor::cellCol(anchor);
+    newRow = LevelDescriptor::cellRow(anchor);
+    return anchor != state.cells[tileIndex] || willDisappear;
 }
 
-bool GameState::operator==(const GameState& other) const {
-    if (tiles.size() != other.tiles.size()) return false;
+std::vector<Move> PuzzleSolver::getPossibleMoves(const SearchState& state) {
+    std::vector<Move> moves;
+    int tileCount = state.level->tileCount();
     
-    for (size_t i = 0; i < tiles.size(); i++) {
-        if (tiles[i].gridCol != other.tiles[i].gridCol ||
-            tiles[i].gridRow != other.tiles[i].gridRow ||
-            tiles[i].unitType != other.tiles[i].unitType) {
-            return false;
+    for (int i = 0; i < tileCount; i++) {
+        if (state.exited(i)) continue;
+        
+        for (int dir = firstDirection(state, i); dir <= lastDirection(state, i); dir++) {
+            int newCol, newRow;
+            bool willDisappear;
+            
+            if (canSlideTile(state, i, static_cast<Direction>(dir), newCol, newRow, willDisappear)) {
+                if (newCol != state.col(i) || newRow != state.row(i) || willDisappear) {
+                    moves.push_back({i, newCol, newRow, willDisappear});
+                }
+            }
         }
     }
-    return true;
+    
+    return moves;
+}
+
+// Same moves and order as above, read from the cache instead of walking
+// every tile's rays again.
+std::vector<Move> PuzzleSolver::getPossibleMoves(const SearchState& state, MoveCache& moveCache) {
+    std::vector<Move> moves;
+    int tileCount = state.level->tileCount();
+    
+    for (int i = 0; i < tileCount; i++) {
+        const MoveCache::TileMoves& slides = moveCache.moves(state, i);
+        for (int k = 0; k < slides.count; k++) {
+            moves.push_back({i, LevelDescriptor::cellCol(slides.anchors[k]), LevelDescriptor::cellRow(slides.anchors[k]),
+                             slides.exits[k] != 0});
+        }
+    }
+    
+    return moves;
 }
 
-size_t GameState::hash() const {
-    size_t h = 0;
-    for (const auto& tile : tiles) {
-        h ^= std::hash<int>{}(tile.gridCol) + 0x9e3779b9 + (h << 6) + (h >> 2);
-        h ^= std::hash<int>{}(tile.gridRow) + 0x9e3779b9 + (h << 6) + (h >> 2);
-        h ^= std::hash<int>{}(static_cast<int>(tile.unitType)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+std::vector<Transition> PuzzleSolver::getTransitions(const SearchState& state, MoveCache& moveCache) {
+    std::vector<Transition> transitions;
+    int tileCount = state.level->tileCount();
+    
+    for (int i = 0; i < tileCount; i++) {
+        const MoveCache::TileMoves& slides = moveCache.moves(state, i);
+        for (int k = 0; k < slides.count; k++) {
+            Transition transition;
+            transition.move = {i, LevelDescriptor::cellCol(slides.anchors[k]), LevelDescriptor::cellRow(slides.anchors[k]),
+                               slides.exits[k] != 0};
+            transition.reads = slides.reads[k];
+            transition.writes = state.footprint(i);
+            if (!slides.exits[k]) {
+                transition.writes |= state.level->footprint(i, slides.anchors[k]);
+            }
+            transitions.push_back(transition);
+        }
     }
-    return h;
+    
+    return transitions;
 }
 
-size_t GameStateHash::operator()(const GameState& state) const {
-    return state.hash();
+bool PuzzleSolver::hasDogEscaped(const SearchState& state) {
+    int dogIndex = state.level->getDogIndex();
+    return dogIndex >= 0 && state.exited(dogIndex);
 }
 
-bool PuzzleSolver::isOutOfBounds(int col, int row, int colSpan, int rowSpan) {
-    return col < 1 || col + colSpan - 1 > gridSize ||
-           row < 1 || row + rowSpan - 1 > gridSize;
+int PuzzleSolver::targetCell(const Move& move) {
+    return move.disappeared ? SearchState::EXITED : Bitboard::cellIndex(move.newCol, move.newRow);
 }
 
-bool PuzzleSolver::checkCollision(const std::vector<Tile>& tiles, int excludeIndex, 
-                                   int col, int row, int colSpan, int rowSpan) {
-    int tileLeft = col;
-    int tileRight = col + colSpan - 1;
-    int tileTop = row;
-    int tileBottom = row + rowSpan - 1;
+bool PuzzleSolver::markVisited(StateTable& visited, const SearchState& state) {
+    if (static_cast<int>(visited.size()) > maxStates) {
+        limitReached = true;
+        return false;
+    }
+    return visited.insert(state.visitedKey(keyScratch), state.hash).second;
+}
+
+bool PuzzleSolver::markVisited(BitstateSet& visited, const SearchState& state) {
+    return visited.insert(state.hash);
+}
+
+// Sleep sets: once a move has been explored from a node, later siblings
+// whose subtrees could replay it in a commuting order carry it in their
+// sleep set and skip it, since the resulting states are covered by the
+// earlier branch. A sleeping move is dropped from the set as soon as a
+// move that does not commute with it is made.
+template <typename VisitedSet>
+bool PuzzleSolver::solveDFS(SearchState& state, MoveCache& moveCache, std::vector<Move>& solution,
+                            int depth, VisitedSet& visited, const std::vector<Transition>& sleep) {
+    if (shouldTerminate || checkTimeout()) return false;
+    if (depth > maxDepth) {
+        limitReached = true;
+        return false;
+    }
+    
+    if (!markVisited(visited, state)) return false;
     
-    for (size_t i = 0; i < tiles.size(); i++) {
-        if (i == static_cast<size_t>(excludeIndex)) continue;
+    if (hasDogEscaped(state)) return true;
+    
+    auto transitions = getTransitions(state, moveCache);
+    int dogIndex = state.level->getDogIndex();
+    
+    // Dog moves first; among the rest, clearing a wolf off the board is
+    // usually progress, so try exits before slides.
+    auto others = std::stable_partition(transitions.begin(), transitions.end(),
+                                        [dogIndex](const Transition& t) { return t.move.tileIndex == dogIndex; });
+    std::stable_partition(others, transitions.end(), [](const Transition& t) { return t.move.disappeared; });
+    
+    std::vector<Transition> asleep = sleep;
+    std::vector<Transition> childSleep;
+    
+    for (const auto& transition : transitions) {
+        if (shouldTerminate) return false;
         
-        const Tile& other = tiles[i];
-        int otherLeft = other.gridCol;
-        int otherRight = other.gridCol + other.gridColSpan - 1;
-        int otherTop = other.gridRow;
-        int otherBottom = other.gridRow + other.gridRowSpan - 1;
+        const Move& move = transition.move;
+        if (move.tileIndex == dogIndex && move.disappeared) {
+            solution.push_back(move);
+            return true;
+        }
+        
+        bool sleeping = false;
+        for (const auto& slept : asleep) {
+            if (slept.move.tileIndex == move.tileIndex && slept.move.newCol == move.newCol &&
+                slept.move.newRow == move.newRow && slept.move.disappeared == move.disappeared) {
+                sleeping = true;
+                break;
+            }
+        }
+        if (sleeping) continue;
+        
+        childSleep.clear();
+        for (const auto& slept : asleep) {
+            if (slept.commutesWith(transition)) childSleep.push_back(slept);
+        }
+        
+        moveCache.makeMove(state, move.tileIndex, targetCell(move));
         
-        if (tileLeft <= otherRight && tileRight >= otherLeft &&
-            tileTop <= otherBottom && tileBottom >= otherTop) {
+        solution.push_back(move);
+        if (solveDFS(state, moveCache, solution, depth + 1, visited, childSleep)) {
             return true;
         }
+        solution.pop_back();
+        
+        moveCache.unmakeMove(state);
+        asleep.push_back(transition);
     }
+    
     return false;
 }
 
-bool PuzzleSolver::canSlideTile(const std::vector<Tile>& tiles, int tileIndex, 
-                                Direction dir, int& newCol, int& newRow, bool& willDisappear) {
-    const Tile& tile = tiles[tileIndex];
-    const DirectionVector& vec = DIRECTION_VECTORS[static_cast<int>(dir)];
+bool PuzzleSolver::solveBFS(const SearchState& initial, std::vector<Move>& solution) {
+    StateTable visited(initial.cells.size(), static_cast<size_t>(maxStates) + 1);
+    std::vector<SearchNode> nodes;
+    nodes.reserve(std::min<size_t>(static_cast<size_t>(maxStates) + 1, size_t(1) << 22));
     
-    int currentCol = tile.gridCol;
-    int currentRow = tile.gridRow;
-    newCol = currentCol;
-    newRow = currentRow;
-    willDisappear = false;
+    visited.insert(initial.visitedKey(keyScratch), initial.hash);
+    nodes.push_back({0, {-1, 0, 0, false}});
     
-    while (true) {
-        int nextCol = newCol + vec.col;
-        int nextRow = newRow + vec.row;
+    SearchState currentState = initial;
+    int dogIndex = initial.level->getDogIndex();
+    uint32_t head = 0;
+    int iterations = 0;
+    
+    while (head < visited.size()) {
+        if (shouldTerminate || checkTimeout()) return false;
         
-        if (isOutOfBounds(nextCol, nextRow, tile.gridColSpan, tile.gridRowSpan)) {
-            willDisappear = true;
-            return true;
+        iterations++;
+        if (iterations > maxStates) {
+            limitReached = true;
+            return false;
         }
         
-        if (checkCollision(tiles, tileIndex, nextCol, nextRow, tile.gridColSpan, tile.gridRowSpan)) {
-            return newCol != currentCol || newRow != currentRow;
-        }
+        uint32_t current = head++;
+        currentState.assign(visited.state(current), visited.hashAt(current));
         
-        newCol = nextCol;
-        newRow = nextRow;
+        auto moves = getPossibleMoves(currentState);
+        
+        for (const auto& move : moves) {
+            if (shouldTerminate) return false;
+            
+            if (move.disappeared && move.tileIndex == dogIndex) {
+                solution = tracePath(nodes, current);
+                solution.push_back(move);
+                relabelPath(initial, solution);
+                return true;
+            }
+            
+            int oldCell = currentState.cells[move.tileIndex];
+            currentState.moveTile(move.tileIndex, targetCell(move));
+            
+            if (visited.insert(currentState.visitedKey(keyScratch, move.tileIndex), currentState.hash).second) {
+                nodes.push_back({current, move});
+            }
+            
+            currentState.moveTile(move.tileIndex, oldCell);
+        }
     }
+    
+    return false;
 }
 
-std::vector<Move> PuzzleSolver::getPossibleMoves(const std::vector<Tile>& tiles) {
-    std::vector<Move> moves;
+// The breadth-first searches and A* expand stored states. With merged wolves
+// those are canonical, so a stored move names its tile by the index
+// it has in the canonical parent. Replays the path from the real initial
+// state and renames each move to the wolf that actually stands on that cell.
+void PuzzleSolver::relabelPath(const SearchState& initial, std::vector<Move>& path) const {
+    if (!initial.level->hasInterchangeable()) return;
     
-    for (size_t i = 0; i < tiles.size(); i++) {
-        for (int dir = 0; dir < 4; dir++) {
-            int newCol, newRow;
-            bool willDisappear;
+    SearchState state = initial;
+    std::vector<uint8_t> canonical(state.cells.size());
+    for (auto& move : path) {
+        initial.level->canonicalize(state.cells.data(), canonical.data());
+        int fromCell = canonical[move.tileIndex];
+        for (int member : initial.level->interchangeableWith(move.tileIndex)) {
+            if (state.cells[member] == fromCell) {
+                move.tileIndex = member;
+                break;
+            }
+        }
+        state.moveTile(move.tileIndex, targetCell(move));
+    }
+}
+
+std::vector<Move> PuzzleSolver::tracePath(const std::vector<SearchNode>& nodes, uint32_t index) {
+    std::vector<Move> path;
+    while (index != 0) {
+        path.push_back(nodes[index].move);
+        index = nodes[index].parent;
+    }
+    
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+// Breadth-first search whose layers live in an ExternalFrontier, so only
+// maxStates states are held in memory at a time and the state limit no
+// longer ends the search; depth, time and disk are the remaining bounds.
+// Solutions are still shortest.
+bool PuzzleSolver::solveExternalBFS(const SearchState& initial, std::vector<Move>& solution) {
+    std::string parent = spillDirectory.empty() ? std::filesystem::temp_directory_path().string() : spillDirectory;
+    ExternalFrontier frontier(parent, initial.cells.size(), static_cast<size_t>(maxStates));
+    
+    frontier.add(initial.visitedKey(keyScratch), initial.hash);
+    frontier.finishLayer();
+    
+    SearchState currentState = initial;
+    std::vector<uint8_t> record(frontier.bytesPerRecord());
+    int dogIndex = initial.level->getDogIndex();
+    
+    for (int depth = 0; frontier.ok(); depth++) {
+        if (depth > maxDepth) {
+            limitReached = true;
+            return false;
+        }
+        
+        ExternalFrontier::Reader layer = frontier.readLayer(depth);
+        while (layer.next(record.data())) {
+            if (shouldTerminate || checkTimeout()) return false;
             
-            if (canSlideTile(tiles, i, static_cast<Direction>(dir), newCol, newRow, willDisappear)) {
-                if (newCol != tiles[i].gridCol || newRow != tiles[i].gridRow || willDisappear) {
-                    moves.push_back({static_cast<int>(i), newCol, newRow, willDisappear});
+            currentState.assign(ExternalFrontier::recordState(record.data()), ExternalFrontier::recordHash(record.data()));
+            
+            for (const auto& move : getPossibleMoves(currentState)) {
+                if (move.disappeared && move.tileIndex == dogIndex) {
+                    solution = traceExternalPath(frontier, currentState, depth);
+                    solution.push_back(move);
+                    relabelPath(initial, solution);
+                    return true;
                 }
+                
+                int oldCell = currentState.cells[move.tileIndex];
+                currentState.moveTile(move.tileIndex, targetCell(move));
+                frontier.add(currentState.visitedKey(keyScratch, move.tileIndex), currentState.hash);
+                currentState.moveTile(move.tileIndex, oldCell);
             }
         }
+        
+        if (frontier.finishLayer() == 0) break;
     }
     
-    return moves;
+    if (!frontier.ok()) limitReached = true;
+    return false;
 }
 
-bool PuzzleSolver::hasDogEscaped(const std::vector<Tile>& tiles) {
-    for (const auto& tile : tiles) {
-        if (tile.unitType == UnitType::DOG) {
-            int right = tile.gridCol + tile.gridColSpan - 1;
-            int bottom = tile.gridRow + tile.gridRowSpan - 1;
-            return tile.gridCol < 1 || right > gridSize || 
-                   tile.gridRow < 1 || bottom > gridSize;
+// Layers keep no parent links, so the path to a goal in layer `depth` is
+// rebuilt backwards: each earlier layer is scanned for a state with a move
+// into the current one.
+std::vector<Move> PuzzleSolver::traceExternalPath(const ExternalFrontier& frontier, const SearchState& goal,
+                                                  int depth) {
+    std::vector<Move> path(depth);
+    std::vector<uint8_t> target(goal.cells);
+    uint64_t targetHash = goal.hash;
+    
+    SearchState parent = goal;
+    std::vector<uint8_t> record(frontier.bytesPerRecord());
+    
+    for (int d = depth - 1; d >= 0; d--) {
+        ExternalFrontier::Reader layer = frontier.readLayer(d);
+        bool found = false;
+        
+        while (!found && layer.next(record.data())) {
+            parent.assign(ExternalFrontier::recordState(record.data()), ExternalFrontier::recordHash(record.data()));
+            
+            for (const auto& move : getPossibleMoves(parent)) {
+                int oldCell = parent.cells[move.tileIndex];
+                parent.moveTile(move.tileIndex, targetCell(move));
+                found = parent.hash == targetHash &&
+                        std::equal(target.begin(), target.end(), parent.visitedKey(keyScratch, move.tileIndex));
+                parent.moveTile(move.tileIndex, oldCell);
+                
+                if (found) {
+                    path[d] = move;
+                    break;
+                }
+            }
         }
+        
+        target.assign(ExternalFrontier::recordState(record.data()),
+                      ExternalFrontier::recordState(record.data()) + target.size());
+        targetHash = ExternalFrontier::recordHash(record.data());
     }
-    return false;
+    
+    return path;
 }
 
-bool PuzzleSolver::solveDFS(std::vector<Tile>& tiles, std::vector<Move>& solution, 
-                            int depth, std::unordered_set<GameState, GameStateHash>& visited) {
-    if (shouldTerminate || checkTimeout()) return false;
-    if (depth > maxDepth) return false;
-    if (static_cast<int>(visited.size()) > maxStates) return false;
+namespace {
+const int IDA_FOUND = -1;
+const size_t FRONTIER_CHUNK = 64;
+const int SPLIT_DEPTH = 2;
+
+struct WorkItem {
+    std::vector<uint8_t> cells;
+    uint64_t hash;
+    int depth;
+    std::vector<Move> path;
+};
+
+// Owner pushes and pops at the back, thieves take the oldest (shallowest,
+// usually largest) subtree from the front.
+struct WorkDeque {
+    std::mutex mutex;
+    std::deque<WorkItem> items;
+};
+
+// One BFS layer as packed states plus the table id of each state, copied out
+// of the visited table so workers can read it while the next layer is being
+// inserted.
+struct FrontierLayer {
+    size_t stateBytes;
+    std::vector<uint8_t> states;
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> ids;
     
-    if (depth % 100 == 0 && checkTimeout()) return false;
+    explicit FrontierLayer(size_t bytes) : stateBytes(bytes) {}
     
-    GameState currentState(tiles);
-    if (visited.count(currentState)) return false;
-    visited.insert(currentState);
+    size_t size() const { return ids.size(); }
+    const uint8_t* state(size_t pos) const { return states.data() + pos * stateBytes; }
     
-    if (hasDogEscaped(tiles)) return true;
+    void add(const uint8_t* state, uint64_t hash, uint32_t id) {
+        states.insert(states.end(), state, state + stateBytes);
+        hashes.push_back(hash);
+        ids.push_back(id);
+    }
     
-    auto moves = getPossibleMoves(tiles);
+    void append(const FrontierLayer& other) {
+        states.insert(states.end(), other.states.begin(), other.states.end());
+        hashes.insert(hashes.end(), other.hashes.begin(), other.hashes.end());
+        ids.insert(ids.end(), other.ids.begin(), other.ids.end());
+    }
+};
+
+struct OpenEntry {
+    int f;
+    int g;
+    uint32_t index;
+};
+
+// Lowest f first; among equal f prefer the deeper node, which is closer to
+// a goal when the heuristic is tight.
+struct OpenEntryOrder {
+    bool operator()(const OpenEntry& a, const OpenEntry& b) const {
+        return a.f != b.f ? a.f > b.f : a.g < b.g;
+    }
+};
+}
+
+// Admissible and consistent lower bound on the moves left until the dog is
+// off the board. The dog needs its exit move, and every tile covering a cell
+// of the dog's path to the edge has to move out of the way first. Under
+// ALL_DIRECTIONS the dog may relocate and escape along another ray, which
+// costs at least one extra move, so the bound there is 1 or 2.
+int PuzzleSolver::escapeLowerBound(const SearchState& state) {
+    int dogIndex = state.level->getDogIndex();
+    if (state.exited(dogIndex)) return 0;
     
-    std::vector<Move> dogMoves;
-    std::vector<Move> otherMoves;
+    const RayTable& rays = state.level->rays(dogIndex);
+    int cell = state.cells[dogIndex];
+    Bitboard others = state.occupancy.andNot(state.footprint(dogIndex));
+    int best = INT_MAX;
     
-    for (const auto& move : moves) {
-        if (tiles[move.tileIndex].unitType == UnitType::DOG) {
-            dogMoves.push_back(move);
-        } else {
-            otherMoves.push_back(move);
+    for (int dir = firstDirection(state, dogIndex); dir <= lastDirection(state, dogIndex); dir++) {
+        Bitboard sweep;
+        for (int step = 1; step <= rays.steps(cell, dir); step++) {
+            const uint8_t* covered = rays.cellsAfter(cell, dir, step);
+            for (int k = 0; k < rays.getArea(); k++) {
+                sweep.setBit(covered[k]);
+            }
+        }
+        
+        if (!sweep.intersects(others)) return 1;
+        
+        if (rules == SolverRules::OWN_DIRECTION) {
+            int blockers = 0;
+            for (int i = 0; i < state.level->tileCount(); i++) {
+                if (i != dogIndex && state.footprint(i).intersects(sweep)) {
+                    blockers++;
+                }
+            }
+            best = std::min(best, blockers);
         }
     }
     
-    for (const auto& move : dogMoves) {
-        if (shouldTerminate) return false;
-        
-        Tile& tile = tiles[move.tileIndex];
-        int oldCol = tile.gridCol;
-        int oldRow = tile.gridRow;
+    return rules == SolverRules::OWN_DIRECTION ? 1 + best : 2;
+}
+
+bool PuzzleSolver::solveAStar(const SearchState& initial, std::vector<Move>& solution) {
+    int dogIndex = initial.level->getDogIndex();
+    if (dogIndex < 0) return false;
+    
+    StateTable visited(initial.cells.size(), static_cast<size_t>(maxStates) + 1);
+    std::vector<SearchNode> nodes;
+    std::vector<int> bestCost;
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, OpenEntryOrder> open;
+    
+    visited.insert(initial.visitedKey(keyScratch), initial.hash);
+    nodes.push_back({0, {-1, 0, 0, false}});
+    bestCost.push_back(0);
+    open.push({escapeLowerBound(initial), 0, 0});
+    
+    SearchState currentState = initial;
+    int iterations = 0;
+    
+    while (!open.empty()) {
+        if (shouldTerminate || stopToken.stopRequested()) return false;
         
-        tile.gridCol = move.newCol;
-        tile.gridRow = move.newRow;
+        OpenEntry entry = open.top();
+        open.pop();
+        if (entry.g > bestCost[entry.index]) continue;
         
-        if (move.disappeared) {
-            return true;
+        iterations++;
+        if (iterations > maxStates) {
+            limitReached = true;
+            return false;
         }
+        if (checkTimeout()) return false;
         
-        solution.push_back(move);
-        if (solveDFS(tiles, solution, depth + 1, visited)) {
-            return true;
-        }
-        solution.pop_back();
+        currentState.assign(visited.state(entry.index), visited.hashAt(entry.index));
         
-        tile.gridCol = oldCol;
-        tile.gridRow = oldRow;
+        // A node from which the dog can leave has a bound of exactly 1, so
+        // it is popped only once no cheaper path can exist.
+        for (const auto& move : getPossibleMoves(currentState)) {
+            if (move.disappeared && move.tileIndex == dogIndex) {
+                solution = tracePath(nodes, entry.index);
+                solution.push_back(move);
+                relabelPath(initial, solution);
+                return true;
+            }
+            
+            int oldCell = currentState.cells[move.tileIndex];
+            currentState.moveTile(move.tileIndex, targetCell(move));
+            
+            int g = entry.g + 1;
+            auto inserted = visited.insert(currentState.visitedKey(keyScratch, move.tileIndex), currentState.hash);
+            if (inserted.second) {
+                nodes.push_back({entry.index, move});
+                bestCost.push_back(g);
+                open.push({g + escapeLowerBound(currentState), g, inserted.first});
+            } else if (g < bestCost[inserted.first]) {
+                nodes[inserted.first] = {entry.index, move};
+                bestCost[inserted.first] = g;
+                open.push({g + escapeLowerBound(currentState), g, inserted.first});
+            }
+            
+            currentState.moveTile(move.tileIndex, oldCell);
+        }
     }
     
-    for (const auto& move : otherMoves) {
-        if (shouldTerminate) return false;
+    return false;
+}
+
+// Level-synchronous BFS: every worker pulls chunks of the current layer and
+// inserts successors into a sharded visited table. Each layer is finished
+// (up to the first escape) before the next one starts, so the first layer
+// with a dog exit still gives a shortest solution.
+bool PuzzleSolver::solveParallelBFS(const SearchState& initial, std::vector<Move>& solution) {
+    int dogIndex = initial.level->getDogIndex();
+    if (dogIndex < 0) return false;
+    
+    size_t stateBytes = initial.cells.size();
+    int workers = threadCount > 0 ? threadCount : ThreadPool::hardwareThreads();
+    ShardedStateTable<SearchNode> visited(stateBytes, static_cast<size_t>(maxStates) + 1);
+    ThreadPool pool(workers);
+    
+    const uint8_t* rootKey = initial.visitedKey(keyScratch);
+    uint32_t root = visited.insert(rootKey, initial.hash, {0, {-1, 0, 0, false}}).first;
+    FrontierLayer frontier(stateBytes);
+    frontier.add(rootKey, initial.hash, root);
+    
+    std::atomic<int> expanded(0);
+    std::atomic<bool> stop(false);
+    
+    while (frontier.size() > 0) {
+        if (shouldTerminate || checkTimeout()) return false;
         
-        Tile& tile = tiles[move.tileIndex];
-        int oldCol = tile.gridCol;
-        int oldRow = tile.gridRow;
+        std::atomic<size_t> cursor(0);
+        std::atomic<size_t> escapeAt(SIZE_MAX);
+        std::mutex escapeMutex;
+        uint32_t escapeParent = root;
+        Move escapeMove = {-1, 0, 0, false};
+        std::vector<FrontierLayer> next(workers, FrontierLayer(stateBytes));
+        std::vector<std::future<void>> done;
         
-        tile.gridCol = move.newCol;
-        tile.gridRow = move.newRow;
+        for (int w = 0; w < workers; w++) {
+            done.push_back(pool.submit([&, w] {
+                SearchState state = initial;
+                FrontierLayer& out = next[w];
+                std::vector<uint8_t> scratch;
+                
+                while (!stop.load(std::memory_order_relaxed)) {
+                    size_t begin = cursor.fetch_add(FRONTIER_CHUNK);
+                    if (begin >= frontier.size()) break;
+                    size_t end = std::min(begin + FRONTIER_CHUNK, frontier.size());
+                    
+                    for (size_t pos = begin; pos < end; pos++) {
+                        if (pos > escapeAt.load(std::memory_order_relaxed)) break;
+                        
+                        int count = expanded.fetch_add(1) + 1;
+                        if (count > maxStates || timeExpired()) {
+                            stop = true;
+                            break;
+                        }
+                        
+                        state.assign(frontier.state(pos), frontier.hashes[pos]);
+                        for (const auto& move : getPossibleMoves(state)) {
+                            if (move.disappeared && move.tileIndex == dogIndex) {
+                                std::lock_guard<std::mutex> lock(escapeMutex);
+                                if (pos < escapeAt) {
+                                    escapeAt = pos;
+                                    escapeParent = frontier.ids[pos];
+                                    escapeMove = move;
+                                }
+                                break;
+                            }
+                            
+                            int oldCell = state.cells[move.tileIndex];
+                            state.moveTile(move.tileIndex, targetCell(move));
+                            
+                            const uint8_t* key = state.visitedKey(scratch, move.tileIndex);
+                            auto inserted = visited.insert(key, state.hash, {frontier.ids[pos], move});
+                            if (inserted.second) {
+                                out.add(key, state.hash, inserted.first);
+                            }
+                            
+                            state.moveTile(move.tileIndex, oldCell);
+                        }
+                    }
+                }
+            }));
+        }
         
-        solution.push_back(move);
-        if (solveDFS(tiles, solution, depth + 1, visited)) {
+        for (auto& task : done) {
+            task.get();
+        }
+        
+        if (escapeAt != SIZE_MAX) {
+            solution.clear();
+            for (uint32_t id = escapeParent; id != root; id = visited.payload(id).parent) {
+                solution.push_back(visited.payload(id).move);
+            }
+            std::reverse(solution.begin(), solution.end());
+            solution.push_back(escapeMove);
+            relabelPath(initial, solution);
             return true;
         }
-        solution.pop_back();
         
-        tile.gridCol = oldCol;
-        tile.gridRow = oldRow;
+        if (stop) {
+            shouldTerminate = true;
+            return false;
+        }
+        
+        FrontierLayer layer(stateBytes);
+        for (const auto& part : next) {
+            layer.append(part);
+        }
+        frontier = std::move(layer);
     }
     
     return false;
 }
 
-bool PuzzleSolver::solveBFS(const std::vector<Tile>& tiles, std::vector<Move>& solution) {
-    std::queue<std::pair<std::vector<Tile>, std::vector<Move>>> queue;
-    std::unordered_set<GameState, GameStateHash> visited;
+struct PuzzleSolver::ParallelDFSContext {
+    ConcurrentHashSet visited;
+    std::vector<WorkDeque> deques;
+    std::atomic<int> pending;
+    std::atomic<int> idle;
+    std::atomic<bool> stop;
+    std::atomic<bool> depthLimited;
+    std::mutex solutionMutex;
+    bool found;
+    std::vector<Move> solution;
     
-    GameState initialState(tiles);
-    visited.insert(initialState);
-    queue.push({tiles, {}});
+    ParallelDFSContext(size_t expectedStates, int workers)
+        : visited(expectedStates), deques(workers), pending(0), idle(0), stop(false), depthLimited(false),
+          found(false) {}
     
-    int iterations = 0;
+    void push(int worker, WorkItem item) {
+        pending.fetch_add(1);
+        std::lock_guard<std::mutex> lock(deques[worker].mutex);
+        deques[worker].items.push_back(std::move(item));
+    }
     
-    while (!queue.empty()) {
-        if (shouldTerminate || checkTimeout()) return false;
+    bool pop(int worker, WorkItem& item) {
+        std::lock_guard<std::mutex> lock(deques[worker].mutex);
+        if (deques[worker].items.empty()) return false;
+        item = std::move(deques[worker].items.back());
+        deques[worker].items.pop_back();
+        return true;
+    }
+    
+    bool steal(int worker, WorkItem& item) {
+        int workers = static_cast<int>(deques.size());
+        for (int k = 1; k < workers; k++) {
+            WorkDeque& victim = deques[(worker + k) % workers];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.items.empty()) {
+                item = std::move(victim.items.front());
+                victim.items.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool hasLocalWork(int worker) {
+        std::lock_guard<std::mutex> lock(deques[worker].mutex);
+        return !deques[worker].items.empty();
+    }
+};
+
+// Same move order as solveDFS: dog moves first, then wolves leaving the
+// board, then the remaining slides.
+void PuzzleSolver::orderMoves(std::vector<Move>& moves, int dogIndex) const {
+    std::stable_partition(moves.begin(), moves.end(),
+                          [](const Move& move) { return move.disappeared; });
+    std::stable_partition(moves.begin(), moves.end(),
+                          [dogIndex](const Move& move) { return move.tileIndex == dogIndex; });
+}
+
+bool PuzzleSolver::searchParallelDFS(ParallelDFSContext& context, int worker, SearchState& state,
+                                     MoveCache& moveCache, std::vector<Move>& path, int depth) {
+    if (context.stop.load(std::memory_order_relaxed)) return false;
+    if (depth > maxDepth) {
+        context.depthLimited.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    
+    if (!context.visited.insert(state.hash)) {
+        if (context.visited.full()) context.stop = true;
+        return false;
+    }
+    
+    size_t explored = context.visited.size();
+    if (static_cast<int>(explored) > maxStates || timeExpired()) {
+        context.stop = true;
+        return false;
+    }
+    
+    int dogIndex = state.level->getDogIndex();
+    auto moves = getPossibleMoves(state, moveCache);
+    orderMoves(moves, dogIndex);
+    
+    if (!moves.empty() && moves[0].tileIndex == dogIndex && moves[0].disappeared) {
+        std::lock_guard<std::mutex> lock(context.solutionMutex);
+        if (!context.found) {
+            context.found = true;
+            context.solution = path;
+            context.solution.push_back(moves[0]);
+        }
+        context.stop = true;
+        return true;
+    }
+    
+    // Near the root, or whenever a worker is starving, hand all but the first
+    // child to the deque so other workers can steal them.
+    size_t recurseCount = moves.size();
+    if (moves.size() > 1 &&
+        (depth < SPLIT_DEPTH || (context.idle.load(std::memory_order_relaxed) > 0 && !context.hasLocalWork(worker)))) {
+        for (size_t i = moves.size() - 1; i > 0; i--) {
+            const Move& move = moves[i];
+            moveCache.makeMove(state, move.tileIndex, targetCell(move));
+            
+            WorkItem item = {state.cells, state.hash, depth + 1, path};
+            item.path.push_back(move);
+            context.push(worker, std::move(item));
+            
+            moveCache.unmakeMove(state);
+        }
+        recurseCount = 1;
+    }
+    
+    for (size_t i = 0; i < recurseCount; i++) {
+        const Move& move = moves[i];
+        moveCache.makeMove(state, move.tileIndex, targetCell(move));
         
-        iterations++;
-        if (iterations > maxStates) return false;
+        path.push_back(move);
+        bool solved = searchParallelDFS(context, worker, state, moveCache, path, depth + 1);
+        path.pop_back();
         
-        if (iterations % 1000 == 0 && checkTimeout()) return false;
+        moveCache.unmakeMove(state);
+        if (solved) return true;
+    }
+    
+    return false;
+}
+
+bool PuzzleSolver::solveParallelDFS(const SearchState& initial, std::vector<Move>& solution) {
+    if (initial.level->getDogIndex() < 0) return false;
+    
+    int workers = threadCount > 0 ? threadCount : ThreadPool::hardwareThreads();
+    ParallelDFSContext context(static_cast<size_t>(maxStates) + 1, workers);
+    context.push(0, {initial.cells, initial.hash, 0, {}});
+    
+    ThreadPool pool(workers);
+    std::vector<std::future<void>> done;
+    
+    for (int w = 0; w < workers; w++) {
+        done.push_back(pool.submit([&, w] {
+            SearchState state = initial;
+            MoveCache moveCache(*initial.level, rules);
+            std::vector<Move> path;
+            WorkItem item;
+            bool hungry = false;
+            
+            while (!context.stop.load(std::memory_order_relaxed)) {
+                if (context.pop(w, item) || context.steal(w, item)) {
+                    if (hungry) {
+                        context.idle.fetch_sub(1);
+                        hungry = false;
+                    }
+                    state.assign(item.cells.data(), item.hash);
+                    moveCache.reset();
+                    path = item.path;
+                    searchParallelDFS(context, w, state, moveCache, path, item.depth);
+                    context.pending.fetch_sub(1);
+                    continue;
+                }
+                
+                if (context.pending.load() == 0) break;
+                if (!hungry) {
+                    context.idle.fetch_add(1);
+                    hungry = true;
+                }
+                std::this_thread::yield();
+            }
+            
+            if (hungry) {
+                context.idle.fetch_sub(1);
+            }
+        }));
+    }
+    
+    for (auto& task : done) {
+        task.get();
+    }
+    
+    if (!context.found) {
+        if (context.stop) shouldTerminate = true;
+        if (context.depthLimited) limitReached = true;
+        return false;
+    }
+    
+    solution = context.solution;
+    return true;
+}
+
+int PuzzleSolver::searchIDAStar(SearchState& state, MoveCache& moveCache, std::vector<Move>& path,
+                                std::vector<uint64_t>& pathHashes, int g, int bound, int& expanded) {
+    int f = g + escapeLowerBound(state);
+    if (f > bound) return f;
+    
+    if (++expanded > maxStates || checkTimeout()) {
+        shouldTerminate = true;
+    }
+    if (shouldTerminate) return INT_MAX;
+    if (g >= maxDepth) {
+        limitReached = true;
+        return INT_MAX;
+    }
+    
+    auto moves = getPossibleMoves(state, moveCache);
+    int dogIndex = state.level->getDogIndex();
+    
+    orderMoves(moves, dogIndex);
+    
+    int nextBound = INT_MAX;
+    for (const auto& move : moves) {
+        if (move.disappeared && move.tileIndex == dogIndex) {
+            path.push_back(move);
+            return IDA_FOUND;
+        }
         
-        auto current = queue.front();
-        queue.pop();
+        moveCache.makeMove(state, move.tileIndex, targetCell(move));
         
-        auto currentTiles = current.first;
-        auto currentMoves = current.second;
+        // Only the current path is remembered; a hash match is treated as a
+        // cycle, which at worst skips a transposition.
+        if (std::find(pathHashes.begin(), pathHashes.end(), state.hash) == pathHashes.end()) {
+            path.push_back(move);
+            pathHashes.push_back(state.hash);
+            
+            int result = searchIDAStar(state, moveCache, path, pathHashes, g + 1, bound, expanded);
+            if (result == IDA_FOUND) {
+                moveCache.unmakeMove(state);
+                return IDA_FOUND;
+            }
+            nextBound = std::min(nextBound, result);
+            
+            path.pop_back();
+            pathHashes.pop_back();
+        }
         
-        auto moves = getPossibleMoves(currentTiles);
+        moveCache.unmakeMove(state);
+    }
+    
+    return nextBound;
+}
+
+bool PuzzleSolver::solveIDAStar(SearchState& state, std::vector<Move>& solution) {
+    if (state.level->getDogIndex() < 0) return false;
+    
+    std::vector<Move> path;
+    std::vector<uint64_t> pathHashes = {state.hash};
+    MoveCache moveCache(*state.level, rules);
+    int expanded = 0;
+    int bound = escapeLowerBound(state);
+    
+    while (bound <= maxDepth) {
+        int result = searchIDAStar(state, moveCache, path, pathHashes, 0, bound, expanded);
+        if (result == IDA_FOUND) {
+            solution = path;
+            return true;
+        }
+        if (shouldTerminate || result == INT_MAX) return false;
+        bound = result;
+    }
+    
+    limitReached = true;
+    return false;
+}
+
+// Depth-limited search with `remaining` moves left. A subtree that fails is
+// stored with its budget, and a state reached again with no more moves left
+// than a stored failure is skipped; cycles are not pruned otherwise, which
+// would make those entries unsound. cutoff reports whether the budget or
+// the lower bound cut anything, i.e. whether a larger budget could succeed.
+bool PuzzleSolver::searchIDDFS(SearchState& state, MoveCache& moveCache, TranspositionTable& table,
+                               std::vector<Move>& path, int remaining, int& expanded, bool& cutoff) {
+    if (escapeLowerBound(state) > remaining) {
+        cutoff = true;
+        return false;
+    }
+    
+    uint32_t known = table.failedWithin(state.hash);
+    if (known >= static_cast<uint32_t>(remaining)) {
+        if (known != TranspositionTable::EXHAUSTED) cutoff = true;
+        return false;
+    }
+    
+    if (++expanded > maxStates || checkTimeout()) {
+        shouldTerminate = true;
+    }
+    if (shouldTerminate) return false;
+    
+    auto moves = getPossibleMoves(state, moveCache);
+    int dogIndex = state.level->getDogIndex();
+    
+    orderMoves(moves, dogIndex);
+    
+    bool childCutoff = false;
+    for (const auto& move : moves) {
+        if (move.disappeared && move.tileIndex == dogIndex) {
+            path.push_back(move);
+            return true;
+        }
         
-        for (const auto& move : moves) {
-            if (shouldTerminate) return false;
-            
-            auto newTiles = currentTiles;
-            newTiles[move.tileIndex].gridCol = move.newCol;
-            newTiles[move.tileIndex].gridRow = move.newRow;
+        moveCache.makeMove(state, move.tileIndex, targetCell(move));
+        path.push_back(move);
+        
+        bool found = searchIDDFS(state, moveCache, table, path, remaining - 1, expanded, childCutoff);
+        moveCache.unmakeMove(state);
+        if (found) return true;
+        
+        path.pop_back();
+        if (shouldTerminate) return false;
+    }
+    
+    table.storeFailure(state.hash, childCutoff ? static_cast<uint32_t>(remaining) : TranspositionTable::EXHAUSTED);
+    cutoff = cutoff || childCutoff;
+    return false;
+}
+
+// Raises the budget one move at a time, so the first solution is a shortest
+// one. The table carries failures over from earlier iterations; when an
+// iteration fails without any cutoff the level is unsolvable.
+bool PuzzleSolver::solveIDDFS(SearchState& state, std::vector<Move>& solution) {
+    if (state.level->getDogIndex() < 0) return false;
+    
+    TranspositionTable table(transpositionMegabytes);
+    MoveCache moveCache(*state.level, rules);
+    std::vector<Move> path;
+    int expanded = 0;
+    
+    for (int bound = escapeLowerBound(state); bound <= maxDepth; bound++) {
+        bool cutoff = false;
+        if (searchIDDFS(state, moveCache, table, path, bound, expanded, cutoff)) {
+            solution = path;
+            return true;
+        }
+        if (shouldTerminate || !cutoff) return false;
+    }
+    
+    limitReached = true;
+    return false;
+}
+
+// Every cell the tile could cover on an empty board: the footprints at all
+// anchors reachable by chains of slides in its allowed directions.
+Bitboard PuzzleSolver::reachableCells(const SearchState& state, int tileIndex) const {
+    const RayTable& rays = state.level->rays(tileIndex);
+    Bitboard reach = state.footprint(tileIndex);
+    Bitboard anchors;
+    std::vector<int> pending = {state.cells[tileIndex]};
+    anchors.setBit(pending[0]);
+    
+    while (!pending.empty()) {
+        int cell = pending.back();
+        pending.pop_back();
+        
+        for (int dir = firstDirection(state, tileIndex); dir <= lastDirection(state, tileIndex); dir++) {
+            for (int step = 1; step <= rays.steps(cell, dir); step++) {
+                const uint8_t* covered = rays.cellsAfter(cell, dir, step);
+                if (anchors.testBit(covered[0])) break;
+                
+                anchors.setBit(covered[0]);
+                pending.push_back(covered[0]);
+                for (int k = 0; k < rays.getArea(); k++) {
+                    reach.setBit(covered[k]);
+                }
+            }
+        }
+    }
+    
+    return reach;
+}
+
+// Tiles that can influence the dog's escape, in index order. The dog only
+// depends on the cells it can reach; a tile matters when it can reach one
+// of those cells, and then the cells it can reach matter too. Any other
+// tile never covers a cell a relevant slide tests, so its moves can be
+// dropped from any solution and the search can ignore it.
+std::vector<int> PuzzleSolver::relevantTiles(const SearchState& state) const {
+    int tileCount = state.level->tileCount();
+    int dogIndex = state.level->getDogIndex();
+    std::vector<int> relevant;
+    if (dogIndex < 0) {
+        for (int i = 0; i < tileCount; i++) relevant.push_back(i);
+        return relevant;
+    }
+    
+    std::vector<Bitboard> reach(tileCount);
+    for (int i = 0; i < tileCount; i++) {
+        reach[i] = reachableCells(state, i);
+    }
+    
+    std::vector<bool> marked(tileCount, false);
+    marked[dogIndex] = true;
+    Bitboard needed = reach[dogIndex];
+    
+    bool grew = true;
+    while (grew) {
+        grew = false;
+        for (int i = 0; i < tileCount; i++) {
+            if (!marked[i] && reach[i].intersects(needed)) {
+                marked[i] = true;
+                needed |= reach[i];
+                grew = true;
+            }
+        }
+    }
+    
+    for (int i = 0; i < tileCount; i++) {
+        if (marked[i]) relevant.push_back(i);
+    }
+    return relevant;
+}
+
+bool PuzzleSolver::fitsGrid(const PuzzleLevel& level, int gridSize) {
+    if (gridSize > Bitboard::MAX_GRID_SIZE) return false;
+    for (const Tile& tile : level.tiles) {
+        if (tile.gridColSpan < 1 || tile.gridRowSpan < 1 ||
+            !Utils::isInGridBounds(tile.gridCol, tile.gridRow, gridSize) ||
+            !Utils::isInGridBounds(tile.getRight(), tile.getBottom(), gridSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SolveOutcome PuzzleSolver::runStrategy(SolverStrategy searchStrategy, const PuzzleLevel& level,
+                                       std::vector<Move>& solution) {
+    if (!fitsGrid(level, gridSize)) {
+        finishStats(SolveOutcome::INVALID_LEVEL, searchStrategy);
+        return SolveOutcome::INVALID_LEVEL;
+    }
+    
+    if (searchStrategy == SolverStrategy::PORTFOLIO) {
+        return solvePortfolio(level, solution);
+    }
+    
+    shouldTerminate = false;
+    limitReached = false;
+    
+    LevelDescriptor fullDescriptor(level.tiles, gridSize);
+    std::vector<int> relevant = relevantTiles(SearchState(fullDescriptor, level.tiles));
+    std::vector<Tile> tiles;
+    for (int index : relevant) {
+        tiles.push_back(level.tiles[index]);
+    }
+    
+    LevelDescriptor descriptor(tiles, gridSize);
+    if (canonicalStates) {
+        descriptor.mergeInterchangeableWolves(rules == SolverRules::ALL_DIRECTIONS);
+    }
+    SearchState state(descriptor, tiles);
+    bool solved = false;
+    bool bitstate = false;
+    size_t bitstateStates = 0;
+    double bitstateCoverage = 1.0;
+    
+    switch (searchStrategy) {
+        case SolverStrategy::BFS:
+            solved = solveBFS(state, solution);
+            break;
+        case SolverStrategy::EXTERNAL_BFS:
+            solved = solveExternalBFS(state, solution);
+            break;
+        case SolverStrategy::ASTAR:
+            solved = solveAStar(state, solution);
+            break;
+        case SolverStrategy::IDASTAR:
+            solved = solveIDAStar(state, solution);
+            break;
+        case SolverStrategy::IDDFS:
+            solved = solveIDDFS(state, solution);
+            break;
+        case SolverStrategy::PARALLEL_BFS:
+            solved = solveParallelBFS(state, solution);
+            break;
+        case SolverStrategy::PARALLEL_DFS:
+            solved = solveParallelDFS(state, solution);
+            break;
+        default: {
+            MoveCache moveCache(descriptor, rules);
+            if (bitstateMegabytes > 0) {
+                BitstateSet visited(bitstateMegabytes);
+                solved = solveDFS(state, moveCache, solution, 0, visited, {});
+                bitstate = true;
+                bitstateStates = visited.size();
+                bitstateCoverage = visited.estimatedCoverage();
+            } else {
+                StateTable visited(state.cells.size(), static_cast<size_t>(maxStates) + 1);
+                solved = solveDFS(state, moveCache, solution, 0, visited, {});
+            }
+            break;
+        }
+    }
+    
+    SolveOutcome outcome = SolveOutcome::UNSOLVABLE;
+    if (solved) {
+        for (auto& move : solution) {
+            move.tileIndex = relevant[move.tileIndex];
+        }
+        outcome = SolveOutcome::SOLVED;
+    } else if (stopToken.stopRequested()) {
+        outcome = SolveOutcome::CANCELLED;
+    } else if (shouldTerminate || limitReached) {
+        outcome = SolveOutcome::LIMIT_REACHED;
+    }
+    
+    finishStats(outcome, searchStrategy);
+    lastStats.bitstate = bitstate;
+    lastStats.bitstateStates = bitstateStates;
+    lastStats.bitstateCoverage = bitstateCoverage;
+    return outcome;
+}
+
+// Runs DFS, BFS and A* side by side, each on its own copy of this solver.
+// The first member to prove the level solvable or unsolvable wins and stops
+// the others through a shared token; a stop requested on this solver's own
+// token is forwarded to the race.
+SolveOutcome PuzzleSolver::solvePortfolio(const PuzzleLevel& level, std::vector<Move>& solution) {
+    const std::vector<SolverStrategy> members = {SolverStrategy::DFS, SolverStrategy::BFS, SolverStrategy::ASTAR};
+    
+    StopToken race;
+    std::mutex resultMutex;
+    bool decided = false;
+    SolveOutcome outcome = SolveOutcome::LIMIT_REACHED;
+    SolverStrategy winner = SolverStrategy::PORTFOLIO;
+    
+    ThreadPool pool(static_cast<int>(members.size()));
+    std::vector<std::future<void>> done;
+    
+    for (SolverStrategy member : members) {
+        done.push_back(pool.submit([&, member] {
+            PuzzleSolver racer(*this);
+            racer.setStopToken(race);
             
-            if (move.disappeared) {
-                solution = currentMoves;
-                solution.push_back(move);
-                return true;
+            std::vector<Move> path;
+            SolveOutcome result = racer.runStrategy(member, level, path);
+            // A bitstate DFS can skip states a hash collision marked visited,
+            // so its UNSOLVABLE must not cancel the exact members.
+            if (result == SolveOutcome::UNSOLVABLE && racer.getLastStats().bitstate) {
+                result = SolveOutcome::LIMIT_REACHED;
             }
             
-            GameState newState(newTiles);
-            if (!visited.count(newState)) {
-                visited.insert(newState);
-                
-                auto newMoves = currentMoves;
-                newMoves.push_back(move);
-                
-                queue.push({newTiles, newMoves});
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (!decided && (result == SolveOutcome::SOLVED || result == SolveOutcome::UNSOLVABLE)) {
+                decided = true;
+                outcome = result;
+                winner = member;
+                solution = path;
+                race.requestStop();
             }
+        }));
+    }
+    
+    for (auto& task : done) {
+        while (task.wait_for(std::chrono::milliseconds(5)) != std::future_status::ready) {
+            if (stopToken.stopRequested()) race.requestStop();
         }
+        task.get();
     }
     
-    return false;
+    if (!decided && stopToken.stopRequested()) {
+        outcome = SolveOutcome::CANCELLED;
+    }
+    
+    finishStats(outcome, winner);
+    return outcome;
+}
+
+void PuzzleSolver::finishStats(SolveOutcome outcome, SolverStrategy searchStrategy) {
+    auto elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    lastStats.outcome = outcome;
+    lastStats.strategy = searchStrategy;
+    lastStats.blockerGraph = false;
+    lastStats.bitstate = false;
+    lastStats.bitstateStates = 0;
+    lastStats.bitstateCoverage = 1.0;
+    lastStats.elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    deadline.cancel();
 }
 
 bool PuzzleSolver::isSolvable(const PuzzleLevel& level) {
     shouldTerminate = false;
     startTime = std::chrono::high_resolution_clock::now();
+    deadline.start(timeoutMs);
     
-    std::vector<Tile> tiles = level.tiles;
-    std::vector<Move> solution;
-    std::unordered_set<GameState, GameStateHash> visited;
+    if (rules == SolverRules::OWN_DIRECTION) {
+        BlockerGraph graph(gridSize);
+        DependencyResult dependency = graph.analyze(level);
+        if (dependency.verdict != DependencyVerdict::UNDECIDED) {
+            bool solvable = dependency.verdict == DependencyVerdict::SOLVABLE;
+            finishStats(solvable ? SolveOutcome::SOLVED
+                        : dependency.verdict == DependencyVerdict::INVALID ? SolveOutcome::INVALID_LEVEL
+                                                                           : SolveOutcome::UNSOLVABLE,
+                        strategy);
+            lastStats.blockerGraph = true;
+            return solvable;
+        }
+    }
     
-    return solveDFS(tiles, solution, 0, visited);
+    std::vector<Move> solution;
+    SolverStrategy searchStrategy = strategy == SolverStrategy::DEFAULT ? SolverStrategy::DFS : strategy;
+    return runStrategy(searchStrategy, level, solution) == SolveOutcome::SOLVED;
 }
 
 std::vector<Move> PuzzleSolver::findSolution(const PuzzleLevel& level) {
     shouldTerminate = false;
     startTime = std::chrono::high_resolution_clock::now();
+    deadline.start(timeoutMs);
     
-    std::vector<Tile> tiles = level.tiles;
     std::vector<Move> solution;
-    
-    solveBFS(tiles, solution);
+    SolverStrategy searchStrategy = strategy == SolverStrategy::DEFAULT ? SolverStrategy::BFS : strategy;
+    if (runStrategy(searchStrategy, level, solution) != SolveOutcome::SOLVED) {
+        solution.clear();
+    }
     
     return solution;
 }
@@ -319,3 +1296,71 @@ void PuzzleSolver::setMaxDepth(int depth) {
 void PuzzleSolver::setMaxStates(int states) {
     maxStates = states;
 }
+
+void PuzzleSolver::setRules(SolverRules solverRules) {
+    rules = solverRules;
+}
+
+SolverRules PuzzleSolver::getRules() const {
+    return rules;
+}
+
+void PuzzleSolver::setStrategy(SolverStrategy solverStrategy) {
+    strategy = solverStrategy;
+}
+
+SolverStrategy PuzzleSolver::getStrategy() const {
+    return strategy;
+}
+
+void PuzzleSolver::setThreads(int threads) {
+    threadCount = threads;
+}
+
+int PuzzleSolver::getThreads() const {
+    return threadCount;
+}
+
+void PuzzleSolver::setCanonicalStates(bool enabled) {
+    canonicalStates = enabled;
+}
+
+bool PuzzleSolver::getCanonicalStates() const {
+    return canonicalStates;
+}
+
+void PuzzleSolver::setBitstateMemory(int megabytes) {
+    bitstateMegabytes = megabytes;
+}
+
+int PuzzleSolver::getBitstateMemory() const {
+    return bitstateMegabytes;
+}
+
+void PuzzleSolver::setSpillDirectory(const std::string& directory) {
+    spillDirectory = directory;
+}
+
+const std::string& PuzzleSolver::getSpillDirectory() const {
+    return spillDirectory;
+}
+
+void PuzzleSolver::setTranspositionMemory(int megabytes) {
+    transpositionMegabytes = megabytes;
+}
+
+int PuzzleSolver::getTranspositionMemory() const {
+    return transpositionMegabytes;
+}
+
+void PuzzleSolver::setStopToken(const StopToken& token) {
+    stopToken = token;
+}
+
+const StopToken& PuzzleSolver::getStopToken() const {
+    return stopToken;
+}
+
+const SolverStats& PuzzleSolver::getLastStats() const {
+    return lastStats;
+}
@@ -2,10 +2,18 @@
 #define PUZZLE_SOLVER_H
 
 #include "Tile.h"
+#include "Bitboard.h"
+#include "SearchState.h"
+#include "MoveCache.h"
+#include "StateTable.h"
+#include "BitstateSet.h"
+#include "ExternalFrontier.h"
+#include "TranspositionTable.h"
+#include "SolverOptions.h"
+#include "StopToken.h"
+#include "Deadline.h"
 #include "PuzzleGenerator.h"
 #include <vector>
-#include <queue>
-#include <unordered_set>
 #include <memory>
 #include <chrono>
 
@@ -16,41 +24,137 @@ struct Move {
     bool disappeared;
 };
 
-struct GameState {
-    std::vector<Tile> tiles;
-    std::vector<Move> moves;
-    int moveCount;
+// A move with the cells its slide tested and the cells it changes. Moves of
+// two different tiles commute when neither changes a cell the other read.
+struct Transition {
+    Move move;
+    Bitboard reads;
+    Bitboard writes;
     
-    GameState(const std::vector<Tile>& t) : tiles(t), moveCount(0) {}
-    bool operator==(const GameState& other) const;
-    size_t hash() const;
+    bool commutesWith(const Transition& other) const {
+        return move.tileIndex != other.move.tileIndex && !writes.intersects(other.reads) &&
+               !other.writes.intersects(reads);
+    }
 };
 
-struct GameStateHash {
-    size_t operator()(const GameState& state) const;
+struct SearchNode {
+    uint32_t parent;
+    Move move;
+};
+
+// UNSOLVABLE means the search space was exhausted; LIMIT_REACHED covers the
+// state/depth/time budgets, CANCELLED a stop requested through the token.
+// INVALID_LEVEL is a level with a tile off the board, which no search runs on.
+enum class SolveOutcome {
+    SOLVED,
+    UNSOLVABLE,
+    LIMIT_REACHED,
+    CANCELLED,
+    INVALID_LEVEL
+};
+
+inline std::string solveOutcomeToString(SolveOutcome outcome) {
+    switch (outcome) {
+        case SolveOutcome::SOLVED: return "solved";
+        case SolveOutcome::UNSOLVABLE: return "unsolvable";
+        case SolveOutcome::LIMIT_REACHED: return "limit reached";
+        case SolveOutcome::INVALID_LEVEL: return "invalid level";
+        default: return "cancelled";
+    }
+}
+
+// Result of the last isSolvable/findSolution call. strategy is the search
+// that produced the answer, which for PORTFOLIO is the winning member;
+// blockerGraph is set when the game-rules dependency check answered first.
+// bitstate is set when a DFS ran over a bitstate visited set; an
+// UNSOLVABLE outcome is then only as reliable as bitstateCoverage.
+struct SolverStats {
+    SolveOutcome outcome;
+    SolverStrategy strategy;
+    bool blockerGraph;
+    int elapsedMs;
+    bool bitstate;
+    size_t bitstateStates;
+    double bitstateCoverage;
+    
+    SolverStats() : outcome(SolveOutcome::UNSOLVABLE), strategy(SolverStrategy::DEFAULT), blockerGraph(false),
+                    elapsedMs(0), bitstate(false), bitstateStates(0), bitstateCoverage(1.0) {}
+    
+    std::string decidedBy() const {
+        return blockerGraph ? "blocker-graph" : solverStrategyToString(strategy);
+    }
 };
 
 class PuzzleSolver {
 private:
+    struct ParallelDFSContext;
+    
     int gridSize;
     int maxDepth;
     int maxStates;
-    int timeoutSeconds;
+    int timeoutMs;
+    SolverRules rules;
+    SolverStrategy strategy;
+    int threadCount;
+    bool canonicalStates;
+    int bitstateMegabytes;
+    std::string spillDirectory;
+    int transpositionMegabytes;
+    StopToken stopToken;
+    Deadline deadline;
     bool shouldTerminate;
+    bool limitReached;
+    SolverStats lastStats;
     std::chrono::high_resolution_clock::time_point startTime;
+    std::vector<uint8_t> keyScratch;
     
-    bool checkCollision(const std::vector<Tile>& tiles, int excludeIndex, int col, int row, int colSpan, int rowSpan);
-    bool isOutOfBounds(int col, int row, int colSpan, int rowSpan);
-    bool canSlideTile(const std::vector<Tile>& tiles, int tileIndex, Direction dir, int& newCol, int& newRow, bool& willDisappear);
-    std::vector<Move> getPossibleMoves(const std::vector<Tile>& tiles);
-    bool solveDFS(std::vector<Tile>& tiles, std::vector<Move>& solution, int depth, std::unordered_set<GameState, GameStateHash>& visited);
-    bool solveBFS(const std::vector<Tile>& tiles, std::vector<Move>& solution);
-    bool hasDogEscaped(const std::vector<Tile>& tiles);
+    int firstDirection(const SearchState& state, int tileIndex) const;
+    int lastDirection(const SearchState& state, int tileIndex) const;
+    bool canSlideTile(const SearchState& state, int tileIndex, Direction dir, int& newCol, int& newRow, bool& willDisappear);
+    std::vector<Move> getPossibleMoves(const SearchState& state);
+    std::vector<Move> getPossibleMoves(const SearchState& state, MoveCache& moveCache);
+    std::vector<Transition> getTransitions(const SearchState& state, MoveCache& moveCache);
+    template <typename VisitedSet>
+    bool solveDFS(SearchState& state, MoveCache& moveCache, std::vector<Move>& solution, int depth,
+                  VisitedSet& visited, const std::vector<Transition>& sleep);
+    bool markVisited(StateTable& visited, const SearchState& state);
+    bool markVisited(BitstateSet& visited, const SearchState& state);
+    bool solveBFS(const SearchState& initial, std::vector<Move>& solution);
+    bool solveExternalBFS(const SearchState& initial, std::vector<Move>& solution);
+    std::vector<Move> traceExternalPath(const ExternalFrontier& frontier, const SearchState& goal, int depth);
+    bool solveParallelBFS(const SearchState& initial, std::vector<Move>& solution);
+    bool solveParallelDFS(const SearchState& initial, std::vector<Move>& solution);
+    bool searchParallelDFS(ParallelDFSContext& context, int worker, SearchState& state, MoveCache& moveCache,
+                           std::vector<Move>& path, int depth);
+    void orderMoves(std::vector<Move>& moves, int dogIndex) const;
+    bool solveAStar(const SearchState& initial, std::vector<Move>& solution);
+    bool solveIDAStar(SearchState& state, std::vector<Move>& solution);
+    int searchIDAStar(SearchState& state, MoveCache& moveCache, std::vector<Move>& path,
+                      std::vector<uint64_t>& pathHashes, int g, int bound, int& expanded);
+    bool solveIDDFS(SearchState& state, std::vector<Move>& solution);
+    bool searchIDDFS(SearchState& state, MoveCache& moveCache, TranspositionTable& table, std::vector<Move>& path,
+                     int remaining, int& expanded, bool& cutoff);
+    int escapeLowerBound(const SearchState& state);
+    Bitboard reachableCells(const SearchState& state, int tileIndex) const;
+    std::vector<int> relevantTiles(const SearchState& state) const;
+    SolveOutcome runStrategy(SolverStrategy searchStrategy, const PuzzleLevel& level, std::vector<Move>& solution);
+    SolveOutcome solvePortfolio(const PuzzleLevel& level, std::vector<Move>& solution);
+    void finishStats(SolveOutcome outcome, SolverStrategy searchStrategy);
+    std::vector<Move> tracePath(const std::vector<SearchNode>& nodes, uint32_t index);
+    void relabelPath(const SearchState& initial, std::vector<Move>& path) const;
+    bool hasDogEscaped(const SearchState& state);
+    static int targetCell(const Move& move);
     bool checkTimeout();
+    bool timeExpired() const;
     
 public:
     PuzzleSolver(int size = 14);
     
+    // Cells are packed into Bitboard indices, so a board larger than
+    // Bitboard::MAX_GRID_SIZE or a tile outside the board would alias
+    // another cell; runStrategy refuses such levels as INVALID_LEVEL.
+    static bool fitsGrid(const PuzzleLevel& level, int gridSize);
+    
     bool isSolvable(const PuzzleLevel& level);
     std::vector<Move> findSolution(const PuzzleLevel& level);
     bool fixLevel(PuzzleLevel& level);
@@ -58,6 +162,30 @@ public:
     void setMaxDepth(int depth);
     void setMaxStates(int states);
     void setTimeout(int seconds);
+    void setTimeoutMs(int milliseconds);
+    void setRules(SolverRules solverRules);
+    SolverRules getRules() const;
+    void setStrategy(SolverStrategy solverStrategy);
+    SolverStrategy getStrategy() const;
+    void setThreads(int threads);
+    int getThreads() const;
+    void setCanonicalStates(bool enabled);
+    bool getCanonicalStates() const;
+    // A positive budget makes the DFS keep its visited states in a bitstate
+    // set of that many megabytes instead of an exact table; maxStates then
+    // no longer bounds the search. 0 restores the exact table.
+    void setBitstateMemory(int megabytes);
+    int getBitstateMemory() const;
+    // Where EXTERNAL_BFS writes its layer files; empty uses the system
+    // temporary directory.
+    void setSpillDirectory(const std::string& directory);
+    const std::string& getSpillDirectory() const;
+    // Size of the IDDFS transposition table.
+    void setTranspositionMemory(int megabytes);
+    int getTranspositionMemory() const;
+    void setStopToken(const StopToken& token);
+    const StopToken& getStopToken() const;
+    const SolverStats& getLastStats() const;
 };
 
 #endif
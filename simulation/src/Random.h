@@ -0,0 +1,78 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <random>
+
+// xoshiro256** generator. Cheap enough for the generator's inner loops and
+// fully determined by its seed; it also models UniformRandomBitGenerator, so
+// it can drive std::shuffle directly.
+class Random {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    using result_type = uint64_t;
+
+    explicit Random(uint64_t seedValue = 0) { seed(seedValue); }
+
+    // The four state words are filled by splitmix64, so any seed, zero
+    // included, gives a usable state.
+    void seed(uint64_t value) {
+        for (auto& word : state) {
+            value += 0x9e3779b97f4a7c15ULL;
+            word = mix(value);
+        }
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform in [min, max] by multiply-shift; the bias is below 2^-32 for
+    // the small ranges used here.
+    int nextInt(int min, int max) {
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+        return min + static_cast<int>((static_cast<unsigned __int128>(next()) * range) >> 64);
+    }
+
+    bool nextBool(double probability) {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53 < probability;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~uint64_t(0); }
+    result_type operator()() { return next(); }
+
+    // splitmix64 finalizer.
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Seed of one generation attempt; equal inputs give equal levels no
+    // matter which thread generates them.
+    static uint64_t deriveSeed(uint64_t masterSeed, int levelId, int attempt) {
+        uint64_t h = mix(masterSeed + 0x9e3779b97f4a7c15ULL);
+        h = mix(h ^ static_cast<uint32_t>(levelId));
+        return mix(h ^ (static_cast<uint64_t>(static_cast<uint32_t>(attempt)) << 32));
+    }
+
+    static uint64_t entropySeed() {
+        std::random_device device;
+        return (static_cast<uint64_t>(device()) << 32) ^ device();
+    }
+};
+
+#endif
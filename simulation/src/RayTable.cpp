@@ -0,0 +1,24 @@
+#include "RayTable.h"
+
+RayTable::RayTable(int colSpan, int rowSpan, int gridSize)
+    : area(colSpan * rowSpan), maxSteps(gridSize - 1), stepData(nullptr), cellData(nullptr) {
+    if (gridSize == COMPILED_RAY_GRID && area <= 2) {
+        if (colSpan == 1 && rowSpan == 1) {
+            stepData = COMPILED_RAYS_1X1.steps.data();
+            cellData = COMPILED_RAYS_1X1.cells.data();
+        } else if (colSpan == 2) {
+            stepData = COMPILED_RAYS_2X1.steps.data();
+            cellData = COMPILED_RAYS_2X1.cells.data();
+        } else {
+            stepData = COMPILED_RAYS_1X2.steps.data();
+            cellData = COMPILED_RAYS_1X2.cells.data();
+        }
+        return;
+    }
+
+    ownedSteps.assign(Bitboard::CELLS * 4, 0);
+    ownedCells.assign(static_cast<size_t>(Bitboard::CELLS) * 4 * (maxSteps > 0 ? maxSteps : 1) * area, 0);
+    fillRays(ownedSteps, ownedCells, colSpan, rowSpan, gridSize);
+    stepData = ownedSteps.data();
+    cellData = ownedCells.data();
+}
@@ -0,0 +1,102 @@
+#ifndef RAY_TABLE_H
+#define RAY_TABLE_H
+
+#include "Bitboard.h"
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Diagonal order matches Direction / DIRECTION_VECTORS.
+constexpr int RAY_COL_STEP[4] = {-1, 1, -1, 1};
+constexpr int RAY_ROW_STEP[4] = {-1, -1, 1, 1};
+
+// Ray data for one tile span on a square grid, filled in by fillRays() below
+// at compile time or at run time. steps[cell * 4 + dir] is how many diagonal
+// steps an anchor at cell can take before the tile leaves the grid. The
+// cells covered after each step start at cells[((cell * 4 + dir) * MaxSteps
+// + step) * Area]; the first of them is the new anchor.
+template <int MaxSteps, int Area>
+struct RayData {
+    std::array<uint8_t, Bitboard::CELLS * 4> steps;
+    std::array<uint8_t, Bitboard::CELLS * 4 * MaxSteps * Area> cells;
+};
+
+template <typename Steps, typename Cells>
+constexpr void fillRays(Steps& steps, Cells& cells, int colSpan, int rowSpan, int gridSize) {
+    int maxSteps = gridSize - 1;
+    int area = colSpan * rowSpan;
+
+    for (int row = 1; row <= gridSize; row++) {
+        for (int col = 1; col <= gridSize; col++) {
+            int cell = (row - 1) * Bitboard::STRIDE + (col - 1);
+            bool fits = col + colSpan - 1 <= gridSize && row + rowSpan - 1 <= gridSize;
+
+            for (int dir = 0; dir < 4; dir++) {
+                int ray = cell * 4 + dir;
+                if (!fits) {
+                    steps[ray] = 0;
+                    continue;
+                }
+
+                int colSteps = RAY_COL_STEP[dir] > 0 ? gridSize - (col + colSpan - 1) : col - 1;
+                int rowSteps = RAY_ROW_STEP[dir] > 0 ? gridSize - (row + rowSpan - 1) : row - 1;
+                int count = colSteps < rowSteps ? colSteps : rowSteps;
+                steps[ray] = static_cast<uint8_t>(count);
+
+                for (int step = 1; step <= count; step++) {
+                    int anchorCol = col + step * RAY_COL_STEP[dir];
+                    int anchorRow = row + step * RAY_ROW_STEP[dir];
+                    int out = (ray * maxSteps + step - 1) * area;
+                    for (int r = 0; r < rowSpan; r++) {
+                        for (int c = 0; c < colSpan; c++) {
+                            cells[out++] = static_cast<uint8_t>((anchorRow + r - 1) * Bitboard::STRIDE + anchorCol + c - 1);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <int ColSpan, int RowSpan, int GridSize>
+constexpr RayData<GridSize - 1, ColSpan * RowSpan> compileRays() {
+    RayData<GridSize - 1, ColSpan * RowSpan> data{};
+    fillRays(data.steps, data.cells, ColSpan, RowSpan, GridSize);
+    return data;
+}
+
+// Rays of the standard 1x1, 2x1 and 1x2 tiles on the 14x14 board, built by
+// the compiler.
+constexpr int COMPILED_RAY_GRID = 14;
+inline constexpr auto COMPILED_RAYS_1X1 = compileRays<1, 1, COMPILED_RAY_GRID>();
+inline constexpr auto COMPILED_RAYS_2X1 = compileRays<2, 1, COMPILED_RAY_GRID>();
+inline constexpr auto COMPILED_RAYS_1X2 = compileRays<1, 2, COMPILED_RAY_GRID>();
+
+// Per-span view used by the solver. Points at the compiled tables when they
+// cover the span and grid size, otherwise owns tables built at run time.
+class RayTable {
+private:
+    int area;
+    int maxSteps;
+    const uint8_t* stepData;
+    const uint8_t* cellData;
+    std::vector<uint8_t> ownedSteps;
+    std::vector<uint8_t> ownedCells;
+
+public:
+    RayTable(int colSpan, int rowSpan, int gridSize);
+
+    RayTable(const RayTable&) = delete;
+    RayTable& operator=(const RayTable&) = delete;
+
+    int getArea() const { return area; }
+    int steps(int cell, int dir) const { return stepData[cell * 4 + dir]; }
+
+    // Cells covered after step `step` (1-based) from `cell` along `dir`.
+    const uint8_t* cellsAfter(int cell, int dir, int step) const {
+        return cellData + ((cell * 4 + dir) * maxSteps + step - 1) * area;
+    }
+};
+
+#endif
@@ -0,0 +1,166 @@
+#include "SearchState.h"
+#include <algorithm>
+
+uint64_t zobristKey(int tileIndex, int cell) {
+    uint64_t z = (static_cast<uint64_t>(tileIndex) << 8 | static_cast<uint64_t>(cell)) + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+LevelDescriptor::LevelDescriptor(const std::vector<Tile>& tiles, int size) : gridSize(size), dogIndex(-1) {
+    shapes.reserve(tiles.size());
+    rayTables.reserve(tiles.size());
+    zobristTiles.reserve(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++) {
+        const Tile& tile = tiles[i];
+
+        std::shared_ptr<const RayTable> rays;
+        for (size_t j = 0; j < i && !rays; j++) {
+            if (shapes[j].colSpan == tile.gridColSpan && shapes[j].rowSpan == tile.gridRowSpan) {
+                rays = rayTables[j];
+            }
+        }
+        rayTables.push_back(rays ? rays : std::make_shared<const RayTable>(tile.gridColSpan, tile.gridRowSpan, gridSize));
+
+        TileShape shape;
+        shape.colSpan = tile.gridColSpan;
+        shape.rowSpan = tile.gridRowSpan;
+        shape.unitType = tile.unitType;
+        shape.direction = tile.direction;
+        shape.originMask = Bitboard::rect(1, 1, tile.gridColSpan, tile.gridRowSpan);
+        shapes.push_back(shape);
+        zobristTiles.push_back(static_cast<int>(i));
+
+        if (dogIndex < 0 && tile.unitType == UnitType::DOG) {
+            dogIndex = static_cast<int>(i);
+        }
+    }
+}
+
+void LevelDescriptor::mergeInterchangeableWolves(bool ignoreDirection) {
+    groupOf.assign(shapes.size(), -1);
+    groupSlot.assign(shapes.size(), -1);
+    groups.clear();
+
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const TileShape& shape = shapes[i];
+        if (shape.unitType != UnitType::WOLF || groupOf[i] >= 0) continue;
+
+        std::vector<int> group = {static_cast<int>(i)};
+        for (size_t j = i + 1; j < shapes.size(); j++) {
+            const TileShape& other = shapes[j];
+            if (other.unitType == UnitType::WOLF && other.colSpan == shape.colSpan &&
+                other.rowSpan == shape.rowSpan && (ignoreDirection || other.direction == shape.direction)) {
+                group.push_back(static_cast<int>(j));
+            }
+        }
+        if (group.size() < 2) continue;
+
+        for (size_t k = 0; k < group.size(); k++) {
+            groupOf[group[k]] = static_cast<int>(groups.size());
+            groupSlot[group[k]] = static_cast<int>(k);
+            zobristTiles[group[k]] = group[0];
+        }
+        groups.push_back(group);
+    }
+}
+
+const std::vector<int>& LevelDescriptor::interchangeableWith(int tileIndex) const {
+    static const std::vector<int> none;
+    return groups.empty() || groupOf[tileIndex] < 0 ? none : groups[groupOf[tileIndex]];
+}
+
+void LevelDescriptor::canonicalize(const uint8_t* cells, uint8_t* out) const {
+    std::copy(cells, cells + shapes.size(), out);
+    uint8_t sorted[Bitboard::CELLS];
+    for (const auto& group : groups) {
+        for (size_t k = 0; k < group.size(); k++) {
+            sorted[k] = cells[group[k]];
+        }
+        std::sort(sorted, sorted + group.size());
+        for (size_t k = 0; k < group.size(); k++) {
+            out[group[k]] = sorted[k];
+        }
+    }
+}
+
+void LevelDescriptor::canonicalizeMoved(const uint8_t* cells, int movedTile, uint8_t* out) const {
+    std::copy(cells, cells + shapes.size(), out);
+    if (groupOf[movedTile] < 0) return;
+
+    const std::vector<int>& group = groups[groupOf[movedTile]];
+    int slot = groupSlot[movedTile];
+    uint8_t cell = cells[movedTile];
+    for (; slot > 0 && out[group[slot - 1]] > cell; slot--) {
+        out[group[slot]] = out[group[slot - 1]];
+    }
+    for (; slot + 1 < static_cast<int>(group.size()) && out[group[slot + 1]] < cell; slot++) {
+        out[group[slot]] = out[group[slot + 1]];
+    }
+    out[group[slot]] = cell;
+}
+
+SearchState::SearchState(const LevelDescriptor& descriptor, const std::vector<Tile>& tiles)
+    : level(&descriptor), hash(0) {
+    cells.reserve(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++) {
+        int cell = Bitboard::cellIndex(tiles[i].gridCol, tiles[i].gridRow);
+        cells.push_back(static_cast<uint8_t>(cell));
+        occupancy |= footprint(static_cast<int>(i));
+        hash ^= zobristKey(descriptor.zobristTile(static_cast<int>(i)), cell);
+    }
+}
+
+SearchState::SearchState(const LevelDescriptor& descriptor, const std::vector<uint8_t>& packed, uint64_t packedHash)
+    : level(&descriptor), hash(0) {
+    assign(packed.data(), packedHash);
+}
+
+void SearchState::assign(const uint8_t* packed, uint64_t packedHash) {
+    cells.assign(packed, packed + level->tileCount());
+    hash = packedHash;
+    occupancy = Bitboard();
+    for (size_t i = 0; i < cells.size(); i++) {
+        occupancy |= footprint(static_cast<int>(i));
+    }
+}
+
+int SearchState::slideAnchor(int tileIndex, int dir, bool& exits, Bitboard* scanned) const {
+    const RayTable& rays = level->rays(tileIndex);
+    int cell = cells[tileIndex];
+    int steps = rays.steps(cell, dir);
+    int area = rays.getArea();
+    Bitboard others = occupancy.andNot(footprint(tileIndex));
+
+    int clear = 0;
+    for (; clear < steps; clear++) {
+        const uint8_t* covered = rays.cellsAfter(cell, dir, clear + 1);
+        bool blocked = false;
+        for (int k = 0; k < area && !blocked; k++) {
+            if (scanned) scanned->setBit(covered[k]);
+            blocked = others.testBit(covered[k]);
+        }
+        if (blocked) break;
+    }
+
+    exits = clear == steps;
+    return clear > 0 ? rays.cellsAfter(cell, dir, clear)[0] : cell;
+}
+
+void SearchState::removeTile(int tileIndex) {
+    moveTile(tileIndex, EXITED);
+}
+
+void SearchState::moveTile(int tileIndex, int newCell) {
+    int oldCell = cells[tileIndex];
+    if (oldCell != EXITED) {
+        occupancy = occupancy.andNot(level->footprint(tileIndex, oldCell));
+        hash ^= zobristKey(level->zobristTile(tileIndex), oldCell);
+    }
+    if (newCell != EXITED) {
+        occupancy |= level->footprint(tileIndex, newCell);
+        hash ^= zobristKey(level->zobristTile(tileIndex), newCell);
+    }
+    cells[tileIndex] = static_cast<uint8_t>(newCell);
+}
@@ -0,0 +1,113 @@
+#ifndef SEARCH_STATE_H
+#define SEARCH_STATE_H
+
+#include "Tile.h"
+#include "Bitboard.h"
+#include "RayTable.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+struct TileShape {
+    int colSpan;
+    int rowSpan;
+    UnitType unitType;
+    Direction direction;
+    Bitboard originMask;
+};
+
+uint64_t zobristKey(int tileIndex, int cell);
+
+// Tile geometry that never changes during a search. Built once per level and
+// shared by every state, so a state only has to record where each tile is.
+class LevelDescriptor {
+private:
+    int gridSize;
+    int dogIndex;
+    std::vector<TileShape> shapes;
+    std::vector<std::shared_ptr<const RayTable>> rayTables;
+    std::vector<int> zobristTiles;
+    std::vector<int> groupOf;
+    std::vector<int> groupSlot;
+    std::vector<std::vector<int>> groups;
+
+public:
+    LevelDescriptor(const std::vector<Tile>& tiles, int gridSize);
+
+    int getGridSize() const { return gridSize; }
+    int getDogIndex() const { return dogIndex; }
+    int tileCount() const { return static_cast<int>(shapes.size()); }
+    const TileShape& shape(int tileIndex) const { return shapes[tileIndex]; }
+    const RayTable& rays(int tileIndex) const { return *rayTables[tileIndex]; }
+    int zobristTile(int tileIndex) const { return zobristTiles[tileIndex]; }
+
+    // Wolves of the same span, and of the same direction unless directions
+    // are ignored, can swap places without changing the puzzle. Merged
+    // wolves share a Zobrist identity and canonicalize() sorts their cells,
+    // so permuted states hash and compare equal. Call before building states.
+    void mergeInterchangeableWolves(bool ignoreDirection);
+    bool hasInterchangeable() const { return !groups.empty(); }
+    // Tiles interchangeable with tileIndex (itself included), or empty.
+    const std::vector<int>& interchangeableWith(int tileIndex) const;
+    void canonicalize(const uint8_t* cells, uint8_t* out) const;
+    // Same result for cells that were canonical before movedTile moved.
+    void canonicalizeMoved(const uint8_t* cells, int movedTile, uint8_t* out) const;
+
+    Bitboard footprint(int tileIndex, int cell) const {
+        return shapes[tileIndex].originMask.shifted(cell);
+    }
+
+    static int cellCol(int cell) { return cell % Bitboard::STRIDE + 1; }
+    static int cellRow(int cell) { return cell / Bitboard::STRIDE + 1; }
+};
+
+// Mutable search position: one anchor cell per tile, the derived occupancy
+// mask and a Zobrist hash that is updated incrementally on every move.
+// Tiles that slid off the board are marked EXITED and no longer contribute
+// to the occupancy or the hash.
+struct SearchState {
+    static constexpr uint8_t EXITED = 0xff;
+
+    const LevelDescriptor* level;
+    std::vector<uint8_t> cells;
+    Bitboard occupancy;
+    uint64_t hash;
+
+    SearchState(const LevelDescriptor& descriptor, const std::vector<Tile>& tiles);
+    SearchState(const LevelDescriptor& descriptor, const std::vector<uint8_t>& packed, uint64_t packedHash);
+
+    int col(int tileIndex) const { return LevelDescriptor::cellCol(cells[tileIndex]); }
+    int row(int tileIndex) const { return LevelDescriptor::cellRow(cells[tileIndex]); }
+    bool exited(int tileIndex) const { return cells[tileIndex] == EXITED; }
+    Bitboard footprint(int tileIndex) const {
+        return exited(tileIndex) ? Bitboard() : level->footprint(tileIndex, cells[tileIndex]);
+    }
+
+    // Last anchor reached when sliding the tile along dir; `exits` is set when
+    // the whole ray is clear. Every cell tested on the way is added to
+    // `scanned` when one is given.
+    int slideAnchor(int tileIndex, int dir, bool& exits, Bitboard* scanned = nullptr) const;
+
+    // Bytes to store in a visited table: the cells themselves, or their
+    // canonical order (written to scratch) when wolves were merged.
+    const uint8_t* visitedKey(std::vector<uint8_t>& scratch) const {
+        if (!level->hasInterchangeable()) return cells.data();
+        scratch.resize(cells.size());
+        level->canonicalize(cells.data(), scratch.data());
+        return scratch.data();
+    }
+
+    // Cheaper form for a state that was canonical before movedTile moved.
+    const uint8_t* visitedKey(std::vector<uint8_t>& scratch, int movedTile) const {
+        if (!level->hasInterchangeable()) return cells.data();
+        scratch.resize(cells.size());
+        level->canonicalizeMoved(cells.data(), movedTile, scratch.data());
+        return scratch.data();
+    }
+
+    void assign(const uint8_t* packed, uint64_t packedHash);
+    void moveTile(int tileIndex, int newCell);
+    void removeTile(int tileIndex);
+};
+
+#endif
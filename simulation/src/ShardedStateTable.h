@@ -0,0 +1,68 @@
+#ifndef SHARDED_STATE_TABLE_H
+#define SHARDED_STATE_TABLE_H
+
+#include "StateTable.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+
+// Visited set shared by several search threads. States are spread over
+// 2^shardBits StateTables by hash, each guarded by its own mutex, and every
+// state carries a payload (the BFS parent link) stored next to it. Ids pack
+// the shard into the low bits and the per-shard index above them.
+template <typename Payload>
+class ShardedStateTable {
+private:
+    struct Shard {
+        std::mutex mutex;
+        StateTable table;
+        std::vector<Payload> payloads;
+
+        Shard(size_t stateBytes, size_t expectedStates) : table(stateBytes, expectedStates) {}
+    };
+
+    int shardBits;
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    size_t shardOf(uint64_t hash) const {
+        return static_cast<size_t>((hash * 0x9e3779b97f4a7c15ULL) >> (64 - shardBits));
+    }
+
+public:
+    ShardedStateTable(size_t stateBytes, size_t expectedStates, int bits = 6) : shardBits(bits) {
+        size_t shardCount = size_t(1) << shardBits;
+        shards.reserve(shardCount);
+        for (size_t i = 0; i < shardCount; i++) {
+            shards.push_back(std::make_unique<Shard>(stateBytes, expectedStates / shardCount));
+        }
+    }
+
+    // Thread-safe. Returns the id of the state and whether it was new; the
+    // payload is only stored for new states.
+    std::pair<uint32_t, bool> insert(const uint8_t* state, uint64_t hash, const Payload& payload) {
+        size_t shardIndex = shardOf(hash);
+        Shard& shard = *shards[shardIndex];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto inserted = shard.table.insert(state, hash);
+        if (inserted.second) {
+            shard.payloads.push_back(payload);
+        }
+        return {inserted.first << shardBits | static_cast<uint32_t>(shardIndex), inserted.second};
+    }
+
+    // Not synchronised; only call while no insert is running.
+    const Payload& payload(uint32_t id) const {
+        return shards[id & ((1u << shardBits) - 1)]->payloads[id >> shardBits];
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& shard : shards) {
+            total += shard->table.size();
+        }
+        return total;
+    }
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "SolverFlags.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+FlagStatus applySolverFlag(PuzzleSolver& solver, int argc, char* argv[], int& i) {
+    if (strcmp(argv[i], "--game-rules") == 0) {
+        solver.setRules(SolverRules::OWN_DIRECTION);
+    } else if (strcmp(argv[i], "--canonical") == 0) {
+        solver.setCanonicalStates(true);
+    } else if (i + 1 >= argc) {
+        return FlagStatus::UNKNOWN;
+    } else if (strcmp(argv[i], "--strategy") == 0) {
+        SolverStrategy strategy;
+        if (!solverStrategyFromString(argv[++i], strategy)) {
+            std::cerr << "Unknown strategy: " << argv[i] << " (expected one of: " << solverStrategyNames() << ")"
+                      << std::endl;
+            return FlagStatus::INVALID;
+        }
+        solver.setStrategy(strategy);
+    } else if (strcmp(argv[i], "--threads") == 0) {
+        solver.setThreads(std::atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--max-states") == 0) {
+        solver.setMaxStates(std::atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--bitstate") == 0) {
+        solver.setBitstateMemory(std::atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--spill-dir") == 0) {
+        solver.setSpillDirectory(argv[++i]);
+    } else if (strcmp(argv[i], "--tt-mb") == 0) {
+        solver.setTranspositionMemory(std::atoi(argv[++i]));
+    } else if (strcmp(argv[i], "--timeout-ms") == 0) {
+        int timeoutMs = std::atoi(argv[++i]);
+        if (timeoutMs > 0) solver.setTimeoutMs(timeoutMs);
+    } else {
+        return FlagStatus::UNKNOWN;
+    }
+    return FlagStatus::APPLIED;
+}
+
+void printSolverFlagUsage(std::ostream& out) {
+    out << "  --game-rules    Solve with game rules (tiles only slide in their own direction)" << std::endl;
+    out << "  --strategy <s>  Solver strategy: " << solverStrategyNames() << std::endl;
+    out << "  --threads <n>   Threads for the parallel strategies (default: all cores)" << std::endl;
+    out << "  --max-states <n> Solver state budget per level (default: 1000000)" << std::endl;
+    out << "  --canonical     Treat interchangeable wolves as one state in the solver" << std::endl;
+    out << "  --bitstate <mb> Let the DFS use a bitstate visited set of this size" << std::endl;
+    out << "  --spill-dir <d> Directory for external-bfs layer files (default: system temp)" << std::endl;
+    out << "  --tt-mb <mb>    Transposition table size for iddfs (default: 64)" << std::endl;
+    out << "  --timeout-ms <n> Solver time budget per level in milliseconds (default: 10000)" << std::endl;
+}
@@ -0,0 +1,21 @@
+#ifndef SOLVER_FLAGS_H
+#define SOLVER_FLAGS_H
+
+#include "PuzzleSolver.h"
+#include <ostream>
+
+// Command line flags that configure a PuzzleSolver, shared by puzzle_sim,
+// level_validator and the difficulty analyzer.
+enum class FlagStatus {
+    UNKNOWN,
+    APPLIED,
+    INVALID
+};
+
+// Applies argv[i] to solver when it is a solver flag, advancing i past its
+// argument. INVALID means the flag was recognised but its value was not;
+// the error has already been printed.
+FlagStatus applySolverFlag(PuzzleSolver& solver, int argc, char* argv[], int& i);
+void printSolverFlagUsage(std::ostream& out);
+
+#endif
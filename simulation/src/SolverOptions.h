@@ -0,0 +1,84 @@
+#ifndef SOLVER_OPTIONS_H
+#define SOLVER_OPTIONS_H
+
+#include <array>
+#include <string>
+
+// ALL_DIRECTIONS lets every tile slide along any of the four diagonals.
+// OWN_DIRECTION matches the game, where a tile only slides along its
+// own Tile::direction.
+enum class SolverRules {
+    ALL_DIRECTIONS,
+    OWN_DIRECTION
+};
+
+inline std::string solverRulesToString(SolverRules rules) {
+    return rules == SolverRules::OWN_DIRECTION ? "own direction (game rules)" : "all directions";
+}
+
+// DEFAULT keeps the original pairing: DFS for isSolvable, BFS for
+// findSolution. ASTAR and IDASTAR are guided by a dog-escape lower bound and
+// return shortest solutions; IDASTAR trades re-expansion for O(depth) memory.
+// IDDFS deepens one move at a time and remembers failed subtrees in a
+// fixed-size transposition table, so it is optimal in bounded memory.
+// PARALLEL_BFS expands each BFS layer on a thread pool; PARALLEL_DFS runs
+// the DFS on work-stealing threads and returns the first escape found.
+// EXTERNAL_BFS is a shortest-solution BFS that keeps its layers on disk, so
+// maxStates only sizes its in-memory buffer.
+// PORTFOLIO races DFS, BFS and A* and keeps the first definitive answer.
+enum class SolverStrategy {
+    DEFAULT,
+    DFS,
+    BFS,
+    EXTERNAL_BFS,
+    ASTAR,
+    IDASTAR,
+    IDDFS,
+    PARALLEL_BFS,
+    PARALLEL_DFS,
+    PORTFOLIO
+};
+
+inline std::string solverStrategyToString(SolverStrategy strategy) {
+    switch (strategy) {
+        case SolverStrategy::DFS: return "dfs";
+        case SolverStrategy::BFS: return "bfs";
+        case SolverStrategy::EXTERNAL_BFS: return "external-bfs";
+        case SolverStrategy::ASTAR: return "astar";
+        case SolverStrategy::IDASTAR: return "idastar";
+        case SolverStrategy::IDDFS: return "iddfs";
+        case SolverStrategy::PARALLEL_BFS: return "parallel-bfs";
+        case SolverStrategy::PARALLEL_DFS: return "parallel-dfs";
+        case SolverStrategy::PORTFOLIO: return "portfolio";
+        default: return "default";
+    }
+}
+
+const std::array<SolverStrategy, 10> SOLVER_STRATEGIES = {
+    SolverStrategy::DEFAULT, SolverStrategy::DFS, SolverStrategy::BFS, SolverStrategy::EXTERNAL_BFS,
+    SolverStrategy::ASTAR, SolverStrategy::IDASTAR, SolverStrategy::IDDFS, SolverStrategy::PARALLEL_BFS,
+    SolverStrategy::PARALLEL_DFS, SolverStrategy::PORTFOLIO
+};
+
+// Comma-separated names of every strategy, for usage and error messages.
+inline std::string solverStrategyNames() {
+    std::string names;
+    for (SolverStrategy strategy : SOLVER_STRATEGIES) {
+        if (!names.empty()) names += ", ";
+        names += solverStrategyToString(strategy);
+    }
+    return names;
+}
+
+// Returns false and leaves strategy unchanged when str names no strategy.
+inline bool solverStrategyFromString(const std::string& str, SolverStrategy& strategy) {
+    for (SolverStrategy candidate : SOLVER_STRATEGIES) {
+        if (solverStrategyToString(candidate) == str) {
+            strategy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef STOP_TOKEN_H
+#define STOP_TOKEN_H
+
+#include <atomic>
+#include <memory>
+
+// Shared cancellation flag. Copies refer to the same flag, so any holder can
+// ask every solver sharing the token to give up.
+class StopToken {
+private:
+    std::shared_ptr<std::atomic<bool>> flag;
+
+public:
+    StopToken() : flag(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void requestStop() const { flag->store(true, std::memory_order_relaxed); }
+    bool stopRequested() const { return flag->load(std::memory_order_relaxed); }
+};
+
+#endif
@@ -1,21 +1,15 @@
 #include "Tile.h"
-#include <sstream>
-#include <random>
+#include "Utils.h"
 
 Tile::Tile() : gridCol(0), gridRow(0), gridColSpan(1), gridRowSpan(1), 
                type(TileType::SINGLE), unitType(UnitType::WOLF), direction(Direction::UP_RIGHT) {}
 
 Tile::Tile(int col, int row, int colSpan, int rowSpan, UnitType utype, Direction dir)
-    : gridCol(col), gridRow(row), gridColSpan(colSpan), gridRowSpan(rowSpan),
-      unitType(utype), direction(dir) {
-    
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(100000, 999999);
-    
-    std::ostringstream oss;
-    oss << dis(gen) << "_" << dis(gen);
-    id = oss.str();
+    : Tile(col, row, colSpan, rowSpan, utype, dir, Utils::generateId()) {}
+
+Tile::Tile(int col, int row, int colSpan, int rowSpan, UnitType utype, Direction dir, const std::string& tileId)
+    : id(tileId), unitType(utype), gridCol(col), gridRow(row), gridColSpan(colSpan), gridRowSpan(rowSpan),
+      direction(dir) {
     
     if (gridColSpan > 1) {
         this->type = TileType::HORIZONTAL;
@@ -34,6 +34,7 @@ struct Tile {
 
     Tile();
     Tile(int col, int row, int colSpan, int rowSpan, UnitType type, Direction dir);
+    Tile(int col, int row, int colSpan, int rowSpan, UnitType type, Direction dir, const std::string& tileId);
     
     int getRight() const;
     int getBottom() const;
@@ -0,0 +1,32 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(int megabytes) {
+    size_t budget = static_cast<size_t>(megabytes > 0 ? megabytes : 1) << 20;
+    size_t buckets = 1;
+    while (buckets * 2 * BUCKET_SIZE * sizeof(Entry) <= budget) {
+        buckets <<= 1;
+    }
+    entries.assign(buckets * BUCKET_SIZE, Entry{0, 0});
+    bucketMask = buckets - 1;
+}
+
+uint32_t TranspositionTable::failedWithin(uint64_t hash) const {
+    const Entry* bucket = entries.data() + (hash & bucketMask) * BUCKET_SIZE;
+    for (int i = 0; i < BUCKET_SIZE; i++) {
+        if (bucket[i].remaining != 0 && bucket[i].hash == hash) return bucket[i].remaining;
+    }
+    return 0;
+}
+
+void TranspositionTable::storeFailure(uint64_t hash, uint32_t remaining) {
+    Entry* bucket = entries.data() + (hash & bucketMask) * BUCKET_SIZE;
+    Entry* victim = bucket;
+    for (int i = 0; i < BUCKET_SIZE; i++) {
+        if (bucket[i].remaining != 0 && bucket[i].hash == hash) {
+            if (remaining > bucket[i].remaining) bucket[i].remaining = remaining;
+            return;
+        }
+        if (bucket[i].remaining < victim->remaining) victim = &bucket[i];
+    }
+    *victim = Entry{hash, remaining};
+}
@@ -0,0 +1,39 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Fixed-size table of failed searches for iterative deepening. An entry
+// says that no solution of at most `remaining` moves starts at the state
+// with that hash; EXHAUSTED means none exists at all. Entries are kept in
+// four-way buckets and a full bucket drops its smallest budget, so memory
+// stays at the size given to the constructor. States are matched by their
+// 64-bit hash alone.
+class TranspositionTable {
+public:
+    static constexpr uint32_t EXHAUSTED = 0xffffffffu;
+
+private:
+    static constexpr int BUCKET_SIZE = 4;
+
+    struct Entry {
+        uint64_t hash;
+        uint32_t remaining;
+    };
+
+    std::vector<Entry> entries;
+    size_t bucketMask;
+
+public:
+    explicit TranspositionTable(int megabytes);
+
+    // Largest budget known to fail from this state, or 0.
+    uint32_t failedWithin(uint64_t hash) const;
+    void storeFailure(uint64_t hash, uint32_t remaining);
+
+    size_t capacity() const { return entries.size(); }
+};
+
+#endif
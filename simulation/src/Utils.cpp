@@ -1,21 +1,17 @@
 #include "Utils.h"
 #include "Tile.h"
-#include <random>
-#include <sstream>
-#include <iomanip>
+
+Random& Utils::rng() {
+    thread_local Random random(Random::entropySeed());
+    return random;
+}
 
 int Utils::getRandomInt(int min, int max) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd() + std::chrono::system_clock::now().time_since_epoch().count());
-    std::uniform_int_distribution<> dis(min, max);
-    return dis(gen);
+    return rng().nextInt(min, max);
 }
 
 bool Utils::getRandomBool(double probability) {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::bernoulli_distribution dist(probability);
-    return dist(gen);
+    return rng().nextBool(probability);
 }
 
 Direction Utils::getRandomDirection() {
@@ -30,16 +26,13 @@ Direction Utils::getRandomDirection() {
 }
 
 std::string Utils::generateId() {
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(100000, 999999);
-    
-    std::ostringstream oss;
-    oss << timestamp << "_" << std::setw(6) << std::setfill('0') << dis(gen);
-    return oss.str();
+    return generateId(rng());
+}
+
+std::string Utils::generateId(Random& random) {
+    int first = random.nextInt(100000, 999999);
+    int second = random.nextInt(100000, 999999);
+    return std::to_string(first) + "_" + std::to_string(second);
 }
 
 bool Utils::isPositionValid(int col, int row, int gridSize) {
@@ -2,11 +2,11 @@
 #define UTILS_H
 
 #include "Tile.h"
+#include "Random.h"
 #include <vector>
 #include <string>
 #include <set>
 #include <random>
-#include <chrono>
 #include <algorithm>
 
 class Utils {
@@ -15,15 +15,18 @@ public:
     static bool getRandomBool(double probability = 0.5);
     static Direction getRandomDirection();
     static std::string generateId();
+    static std::string generateId(Random& random);
+    
+    // The calling thread's entropy-seeded generator, for draws that need not
+    // repeat. Level generation uses its own seeded Random instead.
+    static Random& rng();
     
     static bool isPositionValid(int col, int row, int gridSize);
     static bool isInGridBounds(int col, int row, int gridSize);
     
     template<typename T>
     static void shuffle(std::vector<T>& vec) {
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(vec.begin(), vec.end(), g);
+        std::shuffle(vec.begin(), vec.end(), rng());
     }
 };
 
@@ -1,12 +1,16 @@
 #include "PuzzleGenerator.h"
 #include "PuzzleSolver.h"
+#include "SolverFlags.h"
 #include "LevelExporter.h"
 #include "Utils.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <chrono>
 #include <iomanip>
 #include <cstring>
 #include <fstream>
+#include <sstream>
+#include <future>
 
 void printUsage(const char* programName) {
     std::cout << "Usage: " << programName << " [options]" << std::endl;
@@ -18,7 +22,14 @@ void printUsage(const char* programName) {
     std::cout << "  -d <directory>  Output directory (default: ../simulation_json)" << std::endl;
     std::cout << "  -r <retries>    Max retries per level (default: 10)" << std::endl;
     std::cout << "  -s              Skip solvability check (faster generation)" << std::endl;
+    std::cout << "  --constructive  Build levels around a known solution; no solver search" << std::endl;
     std::cout << "  -v              Verbose output with detailed validation" << std::endl;
+    printSolverFlagUsage(std::cout);
+    std::cout << "  -j <jobs>       Generate this many levels at once (0: all cores, default: 1)" << std::endl;
+    std::cout << "  --seed <n>      Master seed; the same seed reproduces the same levels" << std::endl;
+    std::cout << "  --candidates <k> Let the generator solve k retry candidates of a level at once (0: all cores);"
+              << std::endl;
+    std::cout << "                  the lowest solvable attempt wins, so the result does not depend on k" << std::endl;
     std::cout << "  -h              Show this help message" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
@@ -27,6 +38,7 @@ void printUsage(const char* programName) {
     std::cout << "  " << programName << " -n 100 -s                # Generate 100 levels without solvability check" << std::endl;
     std::cout << "  " << programName << " -n 5 -v                  # Generate 5 levels with verbose output" << std::endl;
     std::cout << "  " << programName << " -n 1 --start-id 13       # Generate level 13 only" << std::endl;
+    std::cout << "  " << programName << " -n 500 -j 8              # Generate 500 levels on 8 threads" << std::endl;
 }
 
 void printBanner() {
@@ -44,49 +56,94 @@ struct GenerationStats {
     double totalTime;
     std::vector<int> solvableLevels;
     std::vector<int> unsolvableLevels;
+    
+    GenerationStats() : totalAttempts(0), successfulLevels(0), failedLevels(0), totalTime(0) {}
+};
+
+// One level generated on a worker: its own generator and solver copies, and
+// a buffered log so that output and results can be replayed in id order.
+struct LevelJob {
+    int levelId;
+    bool success;
+    std::vector<PuzzleLevel> levels;
+    GenerationStats stats;
+    std::ostringstream log;
+    
+    LevelJob() : levelId(0), success(false) {}
 };
 
+void mergeJob(const LevelJob& job, std::vector<PuzzleLevel>& validLevels, GenerationStats& stats) {
+    std::cout << job.log.str();
+    validLevels.insert(validLevels.end(), job.levels.begin(), job.levels.end());
+    stats.totalAttempts += job.stats.totalAttempts;
+    stats.solvableLevels.insert(stats.solvableLevels.end(), job.stats.solvableLevels.begin(),
+                                job.stats.solvableLevels.end());
+    stats.unsolvableLevels.insert(stats.unsolvableLevels.end(), job.stats.unsolvableLevels.begin(),
+                                  job.stats.unsolvableLevels.end());
+    if (job.success) {
+        stats.successfulLevels++;
+    } else {
+        stats.failedLevels++;
+    }
+}
+
 bool generateSingleLevel(int levelId, PuzzleGenerator& generator, PuzzleSolver& solver, 
-                         bool checkSolvability, bool verbose, int maxRetries,
-                         std::vector<PuzzleLevel>& validLevels, GenerationStats& stats) {
-    std::cout << "\n----------------------------------------" << std::endl;
-    std::cout << "Generating Level " << levelId << "..." << std::endl;
-    std::cout << "----------------------------------------" << std::endl;
+                         bool constructive, bool candidateSearch, bool checkSolvability, bool verbose,
+                         int maxRetries, std::vector<PuzzleLevel>& validLevels, GenerationStats& stats,
+                         std::ostream& out) {
+    out << "\n----------------------------------------" << std::endl;
+    out << "Generating Level " << levelId << "..." << std::endl;
+    out << "----------------------------------------" << std::endl;
     
-    PuzzleLevel level = generator.generateLevel(levelId);
+    generator.setLog(out);
+    PuzzleLevel level;
+    if (constructive) {
+        level = generator.generateConstructiveLevel(levelId);
+    } else if (candidateSearch) {
+        level = generator.generateSolvableLevel(levelId, maxRetries, solver);
+    } else {
+        level = generator.generateLevel(levelId);
+    }
     
-    std::cout << "  Tiles generated: " << level.tiles.size() << std::endl;
+    out << "  Tiles generated: " << level.tiles.size() << std::endl;
     
     bool hasDog = false;
     for (const auto& tile : level.tiles) {
         if (tile.unitType == UnitType::DOG) {
             hasDog = true;
-            std::cout << "  Dog tile at: (" << tile.gridCol << ", " << tile.gridRow << ")" << std::endl;
-            std::cout << "  Dog tile size: " << tile.gridColSpan << "x" << tile.gridRowSpan << std::endl;
-            std::cout << "  Dog direction: " << Tile::directionToString(tile.direction) << std::endl;
+            out << "  Dog tile at: (" << tile.gridCol << ", " << tile.gridRow << ")" << std::endl;
+            out << "  Dog tile size: " << tile.gridColSpan << "x" << tile.gridRowSpan << std::endl;
+            out << "  Dog direction: " << Tile::directionToString(tile.direction) << std::endl;
             break;
         }
     }
     
     if (!hasDog) {
-        std::cout << "  ERROR: No dog tile found!" << std::endl;
+        out << "  ERROR: No dog tile found!" << std::endl;
         return false;
     }
     
     if (verbose) {
         ValidationReport report = generator.validateLevelWithReport(level);
-        generator.printValidationReport(report);
+        generator.printValidationReport(report, out);
     } else {
-        std::cout << "  Validating level..." << std::endl;
+        out << "  Validating level..." << std::endl;
         if (!generator.validateLevel(level)) {
-            std::cout << "  ERROR: Level validation failed!" << std::endl;
+            out << "  ERROR: Level validation failed!" << std::endl;
             return false;
         }
-        std::cout << "  Validation: PASSED" << std::endl;
+        out << "  Validation: PASSED" << std::endl;
+    }
+    
+    if (constructive) {
+        out << "  Solvability: SOLVABLE by construction (" << level.solution.size() << " moves)" << std::endl;
+        stats.solvableLevels.push_back(levelId);
+        validLevels.push_back(level);
+        return true;
     }
     
     if (checkSolvability) {
-        std::cout << "  Checking solvability..." << std::endl;
+        out << "  Checking solvability..." << std::endl;
         auto startTime = std::chrono::high_resolution_clock::now();
         
         bool solvable = solver.isSolvable(level);
@@ -95,34 +152,34 @@ bool generateSingleLevel(int levelId, PuzzleGenerator& generator, PuzzleSolver&
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
         
         if (solvable) {
-            std::cout << "  Solvability: SOLVABLE (checked in " << duration.count() << "ms)" << std::endl;
+            out << "  Solvability: SOLVABLE (checked in " << duration.count() << "ms)" << std::endl;
             stats.solvableLevels.push_back(levelId);
             validLevels.push_back(level);
             return true;
         } else {
-            std::cout << "  Solvability: NOT SOLVABLE (checked in " << duration.count() << "ms)" << std::endl;
+            out << "  Solvability: NOT SOLVABLE (checked in " << duration.count() << "ms)" << std::endl;
             stats.unsolvableLevels.push_back(levelId);
             
-            std::cout << "  Attempting to regenerate..." << std::endl;
+            out << "  Attempting to regenerate..." << std::endl;
             for (int retry = 0; retry < maxRetries; retry++) {
                 stats.totalAttempts++;
-                PuzzleLevel newLevel = generator.generateLevel(levelId);
+                PuzzleLevel newLevel = generator.generateLevel(levelId, retry + 1);
                 
                 if (generator.validateLevel(newLevel) && solver.isSolvable(newLevel)) {
-                    std::cout << "  SUCCESS: Found solvable level after " << (retry + 1) << " retries" << std::endl;
+                    out << "  SUCCESS: Found solvable level after " << (retry + 1) << " retries" << std::endl;
                     stats.solvableLevels.push_back(levelId);
                     validLevels.push_back(newLevel);
                     return true;
                 }
             }
             
-            std::cout << "  WARNING: Could not generate solvable level after " << maxRetries << " retries" << std::endl;
-            std::cout << "  Using last generated level (may not be solvable)" << std::endl;
+            out << "  WARNING: Could not generate solvable level after " << maxRetries << " retries" << std::endl;
+            out << "  Using last generated level (may not be solvable)" << std::endl;
             validLevels.push_back(level);
             return false;
         }
     } else {
-        std::cout << "  Skipping solvability check" << std::endl;
+        out << "  Skipping solvability check" << std::endl;
         validLevels.push_back(level);
         return true;
     }
@@ -168,10 +225,24 @@ int main(int argc, char* argv[]) {
     std::string outputDir = "../simulation_json";
     std::string outputFile = "levels.json";
     bool checkSolvability = true;
+    bool constructive = false;
+    bool candidateSearch = false;
+    int candidates = 1;
     bool verbose = false;
     int maxRetries = 10;
+    int jobs = 1;
+    bool seeded = false;
+    uint64_t seed = 0;
+    
+    PuzzleSolver solver(14);
+    solver.setMaxDepth(500);
+    solver.setMaxStates(1000000);
     
     for (int i = 1; i < argc; i++) {
+        FlagStatus status = applySolverFlag(solver, argc, argv, i);
+        if (status == FlagStatus::INVALID) return 1;
+        if (status == FlagStatus::APPLIED) continue;
+        
         if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
             levelCount = std::atoi(argv[++i]);
         } else if (strcmp(argv[i], "--start-id") == 0 && i + 1 < argc) {
@@ -184,8 +255,18 @@ int main(int argc, char* argv[]) {
             maxRetries = std::atoi(argv[++i]);
         } else if (strcmp(argv[i], "-s") == 0) {
             checkSolvability = false;
+        } else if (strcmp(argv[i], "--constructive") == 0) {
+            constructive = true;
+        } else if (strcmp(argv[i], "--candidates") == 0 && i + 1 < argc) {
+            candidates = std::atoi(argv[++i]);
+            candidateSearch = true;
         } else if (strcmp(argv[i], "-v") == 0) {
             verbose = true;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jobs = std::atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
         } else if (strcmp(argv[i], "-h") == 0) {
             printUsage(argv[0]);
             return 0;
@@ -200,30 +281,73 @@ int main(int argc, char* argv[]) {
     std::cout << "  - Output file: " << outputFile << std::endl;
     std::cout << "  - Output directory: " << outputDir << std::endl;
     std::cout << "  - Max retries per level: " << maxRetries << std::endl;
-    std::cout << "  - Solvability check: " << (checkSolvability ? "enabled" : "disabled") << std::endl;
+    std::cout << "  - Generator: " << (constructive ? "constructive" : "random") << std::endl;
+    if (candidateSearch && !constructive) {
+        std::cout << "  - Candidates solved at once: " << (candidates > 0 ? candidates : ThreadPool::hardwareThreads())
+                  << std::endl;
+    }
+    std::cout << "  - Solvability check: "
+              << (constructive ? "by construction" : checkSolvability ? "enabled" : "disabled") << std::endl;
     std::cout << "  - Verbose output: " << (verbose ? "enabled" : "disabled") << std::endl;
+    std::cout << "  - Move rules: " << solverRulesToString(solver.getRules()) << std::endl;
+    std::cout << "  - Solver strategy: " << solverStrategyToString(solver.getStrategy()) << std::endl;
+    if (solver.getBitstateMemory() > 0) {
+        std::cout << "  - Bitstate visited set: " << solver.getBitstateMemory() << " MB" << std::endl;
+    }
+    std::cout << "  - Parallel jobs: " << (jobs > 0 ? jobs : ThreadPool::hardwareThreads()) << std::endl;
     std::cout << std::endl;
     
     PuzzleGenerator generator(14, 18);
-    PuzzleSolver solver(14);
     
-    solver.setMaxDepth(500);
-    solver.setMaxStates(50000);
+    if (seeded) {
+        generator.setSeed(seed);
+    }
+    std::cout << "Master seed: " << generator.getSeed() << std::endl;
+    std::cout << std::endl;
+    
+    generator.setSolverRules(solver.getRules());
+    generator.setSolverStrategy(solver.getStrategy());
+    generator.setSolverThreads(solver.getThreads());
+    generator.setCandidateJobs(candidates);
+    generator.setMaxRetries(maxRetries);
     
     std::vector<PuzzleLevel> validLevels;
     GenerationStats stats;
     stats.totalAttempts = levelCount;
-    stats.successfulLevels = 0;
-    stats.failedLevels = 0;
-    stats.totalTime = 0;
     
     auto totalStartTime = std::chrono::high_resolution_clock::now();
     
-    for (int levelId = startId; levelId < startId + levelCount; levelId++) {
-        if (generateSingleLevel(levelId, generator, solver, checkSolvability, verbose, maxRetries, validLevels, stats)) {
-            stats.successfulLevels++;
-        } else {
-            stats.failedLevels++;
+    if (jobs == 1) {
+        for (int levelId = startId; levelId < startId + levelCount; levelId++) {
+            if (generateSingleLevel(levelId, generator, solver, constructive, candidateSearch, checkSolvability,
+                                    verbose, maxRetries, validLevels, stats, std::cout)) {
+                stats.successfulLevels++;
+            } else {
+                stats.failedLevels++;
+            }
+        }
+    } else {
+        // Levels are independent, so each job copies the configured generator
+        // and solver; results are merged in level-id order as they finish.
+        ThreadPool pool(jobs > 0 ? jobs : ThreadPool::hardwareThreads());
+        std::vector<LevelJob> results(levelCount);
+        std::vector<std::future<void>> done;
+        
+        for (int i = 0; i < levelCount; i++) {
+            done.push_back(pool.submit([&, i] {
+                LevelJob& job = results[i];
+                job.levelId = startId + i;
+                PuzzleGenerator jobGenerator(generator);
+                PuzzleSolver jobSolver(solver);
+                job.success = generateSingleLevel(job.levelId, jobGenerator, jobSolver, constructive, candidateSearch,
+                                                  checkSolvability, verbose, maxRetries, job.levels, job.stats,
+                                                  job.log);
+            }));
+        }
+        
+        for (int i = 0; i < levelCount; i++) {
+            done[i].get();
+            mergeJob(results[i], validLevels, stats);
         }
     }
     